@@ -0,0 +1,507 @@
+/* -*- Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2013 University of California, Los Angeles
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Alexander Afanasyev <alexander.afanasyev@ucla.edu>
+ */
+
+#include "ndn-consumer-population.h"
+#include "ns3/ptr.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/packet.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/double.h"
+
+#include "ns3/ndn-app-face.h"
+#include "ns3/ndn-interest.h"
+#include "ns3/ndn-content-object.h"
+#include "ns3/ndnSIM/utils/ndn-rtt-mean-deviation.h"
+#include "ns3/ndnSIM/utils/ndn-zipf-mandelbrot-sampler.h"
+
+#include <sstream>
+#include <limits>
+#include <algorithm>
+#include <boost/lexical_cast.hpp>
+
+NS_LOG_COMPONENT_DEFINE ("ndn.ConsumerPopulation");
+
+namespace ns3 {
+namespace ndn {
+
+NS_OBJECT_ENSURE_REGISTERED (ConsumerPopulation);
+
+const uint32_t ConsumerPopulation::NONE;
+
+TypeId
+ConsumerPopulation::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::ndn::ConsumerPopulation")
+    .SetGroupName ("Ndn")
+    .SetParent<App> ()
+    .AddConstructor<ConsumerPopulation> ()
+
+    .AddAttribute ("Prefix", "Name of the Interest",
+                   StringValue ("/"),
+                   MakeNameAccessor (&ConsumerPopulation::m_interestName),
+                   MakeNameChecker ())
+
+    .AddAttribute ("LifeTime", "LifeTime for interest packet",
+                   StringValue ("2s"),
+                   MakeTimeAccessor (&ConsumerPopulation::m_interestLifeTime),
+                   MakeTimeChecker ())
+
+    .AddAttribute ("MaxRetx", "Maximum number of Interest retransmissions, after which pending requests fail",
+                   UintegerValue (3),
+                   MakeUintegerAccessor (&ConsumerPopulation::m_maxRetx),
+                   MakeUintegerChecker<uint32_t> ())
+
+    .AddAttribute ("Users", "Number of virtual users",
+                   UintegerValue (1000),
+                   MakeUintegerAccessor (&ConsumerPopulation::SetNumberOfUsers, &ConsumerPopulation::GetNumberOfUsers),
+                   MakeUintegerChecker<uint32_t> ())
+
+    .AddAttribute ("Frequency", "Average frequency of requests of one user (Poisson arrivals)",
+                   StringValue ("1.0"),
+                   MakeDoubleAccessor (&ConsumerPopulation::m_frequency),
+                   MakeDoubleChecker<double> (0.0))
+
+    .AddAttribute ("ArrivalTrace", "File with arrivals \"<time> <user> [<content>]\" (if empty, Poisson arrivals are generated)",
+                   StringValue (""),
+                   MakeStringAccessor (&ConsumerPopulation::m_traceFile),
+                   MakeStringChecker ())
+
+    .AddAttribute ("NumberOfContents", "Total number of contents",
+                   StringValue ("1000"),
+                   MakeUintegerAccessor (&ConsumerPopulation::m_N),
+                   MakeUintegerChecker<uint32_t> (1))
+
+    .AddAttribute ("Q", "Parameter of improve rank of Zipf-Mandelbrot distribution",
+                   StringValue ("0.0"),
+                   MakeDoubleAccessor (&ConsumerPopulation::m_q),
+                   MakeDoubleChecker<double> ())
+
+    .AddAttribute ("S", "Parameter of power of Zipf-Mandelbrot distribution",
+                   StringValue ("0.75"),
+                   MakeDoubleAccessor (&ConsumerPopulation::m_s),
+                   MakeDoubleChecker<double> ())
+
+    .AddTraceSource ("UserDelay", "Delay between request of a user and received Data",
+                     MakeTraceSourceAccessor (&ConsumerPopulation::m_userDelay))
+    ;
+
+  return tid;
+}
+
+ConsumerPopulation::ConsumerPopulation ()
+  : m_maxRetx (3)
+  , m_frequency (1.0)
+  , m_N (1000)
+  , m_q (0.0)
+  , m_s (0.75)
+  , m_rand (0, std::numeric_limits<uint32_t>::max ())
+  , m_freeRequest (NONE)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+
+  m_rtt = CreateObject<RttMeanDeviation> ();
+}
+
+ConsumerPopulation::~ConsumerPopulation ()
+{
+}
+
+void
+ConsumerPopulation::SetNumberOfUsers (uint32_t users)
+{
+  m_userRequests.assign (users, 0);
+  m_userSatisfied.assign (users, 0);
+  m_userFailed.assign (users, 0);
+  m_userDelaySum.assign (users, 0.0);
+  m_userDelayMax.assign (users, 0.0);
+}
+
+uint32_t
+ConsumerPopulation::GetNumberOfUsers () const
+{
+  return m_userRequests.size ();
+}
+
+uint32_t
+ConsumerPopulation::GetUserRequests (uint32_t user) const
+{
+  return m_userRequests[user];
+}
+
+uint32_t
+ConsumerPopulation::GetUserSatisfied (uint32_t user) const
+{
+  return m_userSatisfied[user];
+}
+
+uint32_t
+ConsumerPopulation::GetUserFailed (uint32_t user) const
+{
+  return m_userFailed[user];
+}
+
+Time
+ConsumerPopulation::GetUserAverageDelay (uint32_t user) const
+{
+  if (m_userSatisfied[user] == 0)
+    return Seconds (0);
+
+  return Seconds (m_userDelaySum[user] / m_userSatisfied[user]);
+}
+
+Time
+ConsumerPopulation::GetUserMaxDelay (uint32_t user) const
+{
+  return Seconds (m_userDelayMax[user]);
+}
+
+void
+ConsumerPopulation::PrintUserStats (std::ostream &os) const
+{
+  os << "User" << "\t"
+     << "Requests" << "\t"
+     << "Satisfied" << "\t"
+     << "Failed" << "\t"
+     << "AverageDelay" << "\t"
+     << "MaxDelay" << "\n";
+
+  for (uint32_t user = 0; user < GetNumberOfUsers (); user++)
+    {
+      if (m_userRequests[user] == 0)
+        continue;
+
+      os << user << "\t"
+         << m_userRequests[user] << "\t"
+         << m_userSatisfied[user] << "\t"
+         << m_userFailed[user] << "\t"
+         << GetUserAverageDelay (user).ToDouble (Time::S) << "\t"
+         << m_userDelayMax[user] << "\n";
+    }
+}
+
+// Application Methods
+void
+ConsumerPopulation::StartApplication ()
+{
+  NS_LOG_FUNCTION_NOARGS ();
+
+  App::StartApplication ();
+
+  // all attributes are set by now
+  m_zipf = ZipfMandelbrotSampler::Get (m_N, m_q, m_s);
+  m_contentRequests.assign (m_N + 1, NONE); // content ranks are [1, m_N]
+
+  if (!m_traceFile.empty ())
+    {
+      m_trace.open (m_traceFile.c_str (), std::ios::in);
+      if (!m_trace.is_open ())
+        {
+          NS_FATAL_ERROR ("Cannot open arrival trace file " << m_traceFile);
+        }
+    }
+  else if (m_frequency > 0 && GetNumberOfUsers () > 0)
+    {
+      // superposition of Poisson processes of all users
+      m_arrival = ExponentialVariable (1.0 / (m_frequency * GetNumberOfUsers ()));
+    }
+
+  m_startTime = Simulator::Now ();
+  ScheduleNextArrival ();
+}
+
+void
+ConsumerPopulation::StopApplication ()
+{
+  NS_LOG_FUNCTION_NOARGS ();
+
+  Simulator::Cancel (m_arrivalEvent);
+  Simulator::Cancel (m_retxEvent);
+
+  if (m_trace.is_open ())
+    m_trace.close ();
+
+  App::StopApplication ();
+}
+
+void
+ConsumerPopulation::ScheduleNextArrival ()
+{
+  if (m_trace.is_open ())
+    {
+      Time time;
+      uint32_t user, content;
+      if (!ReadNextArrival (time, user, content))
+        {
+          NS_LOG_INFO ("Arrival trace is exhausted");
+          return;
+        }
+
+      m_arrivalEvent = Simulator::Schedule (Max (m_startTime + time - Simulator::Now (), Seconds (0)),
+                                            &ConsumerPopulation::OnArrival, this, user, content);
+    }
+  else
+    {
+      if (m_frequency <= 0 || GetNumberOfUsers () == 0)
+        return;
+
+      uint32_t user = m_rand.GetInteger (0, GetNumberOfUsers () - 1);
+      uint32_t content = m_zipf->Sample (m_rand.GetValue (0.0, 1.0));
+
+      m_arrivalEvent = Simulator::Schedule (Seconds (m_arrival.GetValue ()),
+                                            &ConsumerPopulation::OnArrival, this, user, content);
+    }
+}
+
+bool
+ConsumerPopulation::ReadNextArrival (Time &time, uint32_t &user, uint32_t &content)
+{
+  std::string line;
+  while (std::getline (m_trace, line))
+    {
+      if (line.empty () || line[0] == '#')
+        continue;
+
+      std::istringstream is (line);
+      double seconds;
+      is >> seconds >> user;
+      if (is.fail ())
+        {
+          NS_FATAL_ERROR ("Invalid line in arrival trace " << m_traceFile << ": " << line);
+        }
+      if (user >= GetNumberOfUsers ())
+        {
+          NS_FATAL_ERROR ("User " << user << " in arrival trace is out of range (Users=" << GetNumberOfUsers () << ")");
+        }
+
+      if (!(is >> content))
+        {
+          content = m_zipf->Sample (m_rand.GetValue (0.0, 1.0));
+        }
+      else if (content < 1 || content > m_N)
+        {
+          NS_FATAL_ERROR ("Content " << content << " in arrival trace is out of range [1, " << m_N << "]");
+        }
+
+      time = Seconds (seconds);
+      return true;
+    }
+
+  return false;
+}
+
+void
+ConsumerPopulation::OnArrival (uint32_t user, uint32_t content)
+{
+  if (!m_active) return;
+
+  NS_LOG_FUNCTION (this << user << content);
+
+  m_userRequests[user] ++;
+
+  uint32_t request = AllocateRequest (user);
+  bool alreadyRequested = m_contentRequests[content] != NONE;
+
+  // request should be in the list before Interest is sent, Data may be returned immediately from the local cache
+  m_requestNext[request] = m_contentRequests[content];
+  m_contentRequests[content] = request;
+
+  if (!alreadyRequested)
+    {
+      SendInterest (content);
+    }
+
+  ScheduleNextArrival ();
+}
+
+uint32_t
+ConsumerPopulation::AllocateRequest (uint32_t user)
+{
+  uint32_t request = m_freeRequest;
+  if (request != NONE)
+    {
+      m_freeRequest = m_requestNext[request];
+      m_requestUser[request] = user;
+      m_requestTime[request] = Simulator::Now ();
+    }
+  else
+    {
+      request = m_requestUser.size ();
+      m_requestUser.push_back (user);
+      m_requestTime.push_back (Simulator::Now ());
+      m_requestNext.push_back (NONE);
+    }
+  return request;
+}
+
+void
+ConsumerPopulation::CompleteRequests (uint32_t content, bool delivered)
+{
+  Time now = Simulator::Now ();
+
+  uint32_t request = m_contentRequests[content];
+  while (request != NONE)
+    {
+      uint32_t user = m_requestUser[request];
+      if (delivered)
+        {
+          Time delay = now - m_requestTime[request];
+          double seconds = delay.ToDouble (Time::S);
+
+          m_userSatisfied[user] ++;
+          m_userDelaySum[user] += seconds;
+          m_userDelayMax[user] = std::max (m_userDelayMax[user], seconds);
+
+          m_userDelay (this, user, content, delay);
+        }
+      else
+        {
+          m_userFailed[user] ++;
+        }
+
+      uint32_t next = m_requestNext[request];
+      m_requestNext[request] = m_freeRequest;
+      m_freeRequest = request;
+      request = next;
+    }
+
+  m_contentRequests[content] = NONE;
+}
+
+void
+ConsumerPopulation::SendInterest (uint32_t content)
+{
+  Ptr<Name> name = Create<Name> (m_interestName);
+  (*name) (content);
+
+  Interest interestHeader;
+  interestHeader.SetNonce            (m_rand.GetValue ());
+  interestHeader.SetName             (name);
+  interestHeader.SetInterestLifetime (m_interestLifeTime);
+
+  NS_LOG_INFO ("> Interest for " << content);
+
+  Ptr<Packet> packet = Create<Packet> ();
+  packet->AddHeader (interestHeader);
+
+  m_seqWindow.Sent (content, Simulator::Now ());
+  ScheduleRetxTimeout ();
+
+  m_transmittedInterests (&interestHeader, this, m_face);
+  m_protocolHandler (packet);
+}
+
+void
+ConsumerPopulation::ScheduleRetxTimeout ()
+{
+  if (m_seqWindow.GetOutstandingCount () == 0)
+    return;
+
+  Time deadline = m_seqWindow.GetLastSendTime (m_seqWindow.GetOldestOutstanding ()) + m_rtt->RetransmitTimeout ();
+
+  if (m_retxEvent.IsRunning ())
+    {
+      if (Simulator::Now () + Simulator::GetDelayLeft (m_retxEvent) <= deadline)
+        return; // check is already scheduled before the deadline
+
+      m_retxEvent.Cancel ();
+    }
+
+  m_retxEvent = Simulator::Schedule (Max (deadline - Simulator::Now (), Seconds (0)),
+                                     &ConsumerPopulation::CheckRetxTimeout, this);
+}
+
+void
+ConsumerPopulation::CheckRetxTimeout ()
+{
+  Time now = Simulator::Now ();
+  Time rto = m_rtt->RetransmitTimeout ();
+
+  while (m_seqWindow.GetOutstandingCount () > 0)
+    {
+      uint32_t slot = m_seqWindow.GetOldestOutstanding ();
+      if (m_seqWindow.GetLastSendTime (slot) + rto > now)
+        break; // all later Interests have not yet timed out
+
+      uint32_t content = m_seqWindow.GetSeq (slot);
+      if (m_seqWindow.GetTransmissionCount (slot) > m_maxRetx)
+        {
+          NS_LOG_INFO ("Requests for " << content << " failed");
+          m_seqWindow.Erase (content);
+          CompleteRequests (content, false);
+        }
+      else
+        {
+          SendInterest (content); // moves content to the end of the outstanding list
+        }
+    }
+
+  ScheduleRetxTimeout ();
+}
+
+///////////////////////////////////////////////////
+//          Process incoming packets             //
+///////////////////////////////////////////////////
+
+void
+ConsumerPopulation::OnContentObject (const Ptr<const ContentObject> &contentObject,
+                                     Ptr<Packet> payload)
+{
+  if (!m_active) return;
+
+  App::OnContentObject (contentObject, payload); // tracing inside
+
+  NS_LOG_FUNCTION (this << contentObject << payload);
+
+  uint32_t content = boost::lexical_cast<uint32_t> (contentObject->GetName ().GetComponents ().back ());
+  NS_LOG_INFO ("< DATA for " << content);
+
+  uint32_t slot = m_seqWindow.Find (content);
+  if (slot == SeqWindow::NONE)
+    return; // requests have already been satisfied or failed
+
+  // RTT is sampled only for Interests that were not retransmitted (RttEstimator's history of sequence
+  // numbers is not used, it does not work for random content ranks)
+  if (m_seqWindow.GetTransmissionCount (slot) == 1)
+    {
+      m_rtt->Measurement (Simulator::Now () - m_seqWindow.GetLastSendTime (slot));
+      m_rtt->ResetMultiplier ();
+    }
+
+  m_seqWindow.Erase (content);
+  CompleteRequests (content, true);
+
+  ScheduleRetxTimeout ();
+}
+
+void
+ConsumerPopulation::OnNack (const Ptr<const Interest> &interest, Ptr<Packet> origPacket)
+{
+  if (!m_active) return;
+
+  App::OnNack (interest, origPacket); // tracing inside
+
+  // Interest will be retransmitted (or requests will fail) when the retransmission timer expires
+  NS_LOG_INFO ("< NACK for " << interest->GetName ().GetComponents ().back ());
+}
+
+} // namespace ndn
+} // namespace ns3
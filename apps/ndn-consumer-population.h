@@ -0,0 +1,226 @@
+/* -*- Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2013 University of California, Los Angeles
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Alexander Afanasyev <alexander.afanasyev@ucla.edu>
+ */
+
+#ifndef NDN_CONSUMER_POPULATION_H
+#define NDN_CONSUMER_POPULATION_H
+
+#include "ndn-app.h"
+#include "ns3/random-variable.h"
+#include "ns3/ndn-name.h"
+#include "ns3/nstime.h"
+#include "ns3/ndn-rtt-estimator.h"
+#include "ns3/ndn-seq-window.h"
+
+#include <vector>
+#include <fstream>
+
+#include <boost/shared_ptr.hpp>
+
+namespace ns3 {
+namespace ndn {
+
+class ZipfMandelbrotSampler;
+
+/**
+ * @ingroup ndn
+ * @brief NDN application that multiplexes a population of virtual consumers over a single face
+ *
+ * Requests of all users are generated by one shared arrival process: either a Poisson process
+ * with rate Users*Frequency (each request is assigned to a user chosen uniformly at random), or
+ * a trace file with lines "<time in seconds since start> <user> [<content>]".  If content is not
+ * specified, it is drawn from Zipf-Mandelbrot distribution, shared by all users.
+ *
+ * Requests for content that is already requested by another user do not generate new Interests,
+ * but wait for the same Data (similar to PIT aggregation).  The application keeps only a few
+ * counters per user (number of requests, satisfied and failed requests, sum and maximum of delays),
+ * and per-request state only while the request is pending.
+ */
+class ConsumerPopulation: public App
+{
+public:
+  static TypeId GetTypeId ();
+
+  ConsumerPopulation ();
+  virtual ~ConsumerPopulation ();
+
+  // From App
+  virtual void
+  OnNack (const Ptr<const Interest> &interest, Ptr<Packet> packet);
+
+  virtual void
+  OnContentObject (const Ptr<const ContentObject> &contentObject,
+                   Ptr<Packet> payload);
+
+  /**
+   * @brief Get number of virtual users
+   */
+  uint32_t
+  GetNumberOfUsers () const;
+
+  /**
+   * @brief Get number of requests issued by the user
+   */
+  uint32_t
+  GetUserRequests (uint32_t user) const;
+
+  /**
+   * @brief Get number of requests of the user that were satisfied with Data
+   */
+  uint32_t
+  GetUserSatisfied (uint32_t user) const;
+
+  /**
+   * @brief Get number of requests of the user that failed (all retransmissions timed out)
+   */
+  uint32_t
+  GetUserFailed (uint32_t user) const;
+
+  /**
+   * @brief Get average delay between request and Data for the user (zero if nothing was satisfied)
+   */
+  Time
+  GetUserAverageDelay (uint32_t user) const;
+
+  /**
+   * @brief Get maximum delay between request and Data for the user
+   */
+  Time
+  GetUserMaxDelay (uint32_t user) const;
+
+  /**
+   * @brief Print per-user statistics, one tab-separated line per user that issued at least one request
+   */
+  void
+  PrintUserStats (std::ostream &os) const;
+
+protected:
+  // from App
+  virtual void
+  StartApplication ();
+
+  virtual void
+  StopApplication ();
+
+private:
+  /**
+   * @brief Issue request of the user and schedule the next arrival
+   */
+  void
+  OnArrival (uint32_t user, uint32_t content);
+
+  /**
+   * @brief Schedule the next arrival of the shared arrival process
+   */
+  void
+  ScheduleNextArrival ();
+
+  /**
+   * @brief Read the next arrival from the trace file (returns false when the trace is exhausted)
+   */
+  bool
+  ReadNextArrival (Time &time, uint32_t &user, uint32_t &content);
+
+  /**
+   * @brief Send (or retransmit) Interest for the content
+   */
+  void
+  SendInterest (uint32_t content);
+
+  /**
+   * @brief Arm retransmission timer to the earliest deadline of outstanding Interests
+   */
+  void
+  ScheduleRetxTimeout ();
+
+  /**
+   * @brief Retransmit timed out Interests (or fail their requests when retransmission limit is reached)
+   */
+  void
+  CheckRetxTimeout ();
+
+  /**
+   * @brief Take request record from the free list (or allocate a new one)
+   */
+  uint32_t
+  AllocateRequest (uint32_t user);
+
+  /**
+   * @brief Complete all requests waiting for the content
+   * @param delivered true if Data has been received, false if requests failed
+   */
+  void
+  CompleteRequests (uint32_t content, bool delivered);
+
+  void
+  SetNumberOfUsers (uint32_t users);
+
+private:
+  static const uint32_t NONE = 0xFFFFFFFF;
+
+  Name     m_interestName;      ///< @brief prefix of the requested names
+  Time     m_interestLifeTime;  ///< @brief LifeTime for Interest packets
+  uint32_t m_maxRetx;           ///< @brief maximum number of retransmissions before a request fails
+
+  double      m_frequency;      ///< @brief request rate of one user (Poisson arrivals)
+  std::string m_traceFile;      ///< @brief name of the arrival trace (if empty, Poisson arrivals are used)
+  std::ifstream m_trace;        ///< @brief arrival trace, read one line at a time
+
+  uint32_t m_N;                 ///< @brief total number of contents
+  double   m_q;                 ///< @brief q in (k+q)^s
+  double   m_s;                 ///< @brief s in (k+q)^s
+  boost::shared_ptr<const ZipfMandelbrotSampler> m_zipf; ///< @brief sampler of content ranks (shared between apps)
+
+  UniformVariable     m_rand;    ///< @brief nonces, users, and content ranks
+  ExponentialVariable m_arrival; ///< @brief inter-arrival time of the Poisson process
+  Time                m_startTime;
+  EventId             m_arrivalEvent;
+
+  Ptr<RttEstimator> m_rtt;       ///< @brief RTT estimator, shared by all users
+  SeqWindow         m_seqWindow; ///< @brief transmission times and counts of outstanding contents
+  EventId           m_retxEvent;
+
+  /// @cond include_hidden
+  // per-user state (indexed by user)
+  std::vector<uint32_t> m_userRequests;
+  std::vector<uint32_t> m_userSatisfied;
+  std::vector<uint32_t> m_userFailed;
+  std::vector<double>   m_userDelaySum; // seconds
+  std::vector<double>   m_userDelayMax; // seconds
+
+  // per-content list of pending requests (indexed by content rank)
+  std::vector<uint32_t> m_contentRequests;
+
+  // pool of pending requests (linked into per-content lists, free records are linked into m_freeRequest list)
+  std::vector<uint32_t> m_requestUser;
+  std::vector<Time>     m_requestTime;
+  std::vector<uint32_t> m_requestNext;
+  uint32_t              m_freeRequest;
+  /// @endcond
+
+  /// @cond include_hidden
+  TracedCallback<Ptr<App> /* app */, uint32_t /* user */,
+                 uint32_t /* content */, Time /* delay */> m_userDelay;
+  /// @endcond
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // NDN_CONSUMER_POPULATION_H
@@ -87,8 +87,8 @@ void
 ConsumerWindowAIMD::AdjustWindowOnNack (const Ptr<const Interest> &interest, Ptr<Packet> payload)
 {
   uint32_t seq = boost::lexical_cast<uint32_t> (interest->GetName ().GetComponents ().back ());
-  SeqTimeoutsContainer::iterator entry = m_seqLastDelay.find (seq);
-  if (entry != m_seqLastDelay.end () && entry->time > m_last_decrease)
+  uint32_t slot = m_seqWindow.Find (seq);
+  if (slot != SeqWindow::NONE && m_seqWindow.GetLastSendTime (slot) > m_last_decrease)
     {
       m_ssthresh = std::max<uint32_t> (2, m_inFlight / 2);
       m_window = m_ssthresh;
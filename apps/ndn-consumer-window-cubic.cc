@@ -81,10 +81,10 @@ ConsumerWindowCUBIC::AdjustWindowOnContentObject (const Ptr<const ContentObject>
 {
   // record minimum RTT in m_dMin
   uint32_t seq = boost::lexical_cast<uint32_t> (contentObject->GetName ().GetComponents ().back ());
-  SeqTimeoutsContainer::iterator entry = m_seqLastDelay.find (seq);
-  if (entry != m_seqLastDelay.end ())
+  uint32_t slot = m_seqWindow.Find (seq);
+  if (slot != SeqWindow::NONE)
     {
-      Time rtt = Simulator::Now () - entry->time;
+      Time rtt = Simulator::Now () - m_seqWindow.GetLastSendTime (slot);
       if (m_dMin == Seconds(0.0))
         m_dMin = rtt;
       else
@@ -133,8 +133,8 @@ void
 ConsumerWindowCUBIC::AdjustWindowOnNack (const Ptr<const Interest> &interest, Ptr<Packet> payload)
 {
   uint32_t seq = boost::lexical_cast<uint32_t> (interest->GetName ().GetComponents ().back ());
-  SeqTimeoutsContainer::iterator entry = m_seqLastDelay.find (seq);
-  if (entry != m_seqLastDelay.end () && entry->time > m_last_decrease)
+  uint32_t slot = m_seqWindow.Find (seq);
+  if (slot != SeqWindow::NONE && m_seqWindow.GetLastSendTime (slot) > m_last_decrease)
     {
       m_epoch_start = Seconds(0.0);
 
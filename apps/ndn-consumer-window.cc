@@ -204,8 +204,8 @@ ConsumerWindow::OnTimeout (uint32_t sequenceNumber)
 {
   if (m_inFlight > static_cast<uint32_t> (0)) m_inFlight--;
 
-  SeqTimeoutsContainer::iterator entry = m_seqLastDelay.find (sequenceNumber);
-  if (entry != m_seqLastDelay.end () && entry->time > m_last_decrease)
+  uint32_t slot = m_seqWindow.Find (sequenceNumber);
+  if (slot != SeqWindow::NONE && m_seqWindow.GetLastSendTime (slot) > m_last_decrease)
     {
       AdjustWindowOnTimeout (sequenceNumber);
       m_last_decrease = Simulator::Now();
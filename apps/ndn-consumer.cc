@@ -34,6 +34,7 @@
 #include "ns3/ndn-content-object.h"
 #include "ns3/ndnSIM/utils/ndn-fw-hop-count-tag.h"
 #include "ns3/ndnSIM/utils/ndn-rtt-mean-deviation.h"
+#include "ns3/ndnSIM/utils/ndn-zipf-mandelbrot-sampler.h"
 
 #include <boost/ref.hpp>
 #include <boost/lexical_cast.hpp>
@@ -77,7 +78,7 @@ Consumer::GetTypeId (void)
                    MakeTimeChecker ())
 
     .AddAttribute ("RetxTimer",
-                   "Timeout defining how frequent retransmission timeouts should be checked",
+                   "Minimum interval between checks of retransmission timeouts (timeouts are checked at the earliest deadline of outstanding Interests)",
                    StringValue ("50ms"),
                    MakeTimeAccessor (&Consumer::GetRetxTimer, &Consumer::SetRetxTimer),
                    MakeTimeChecker ())
@@ -146,26 +147,8 @@ Consumer::GetRequestMode (void)
 void
 Consumer::SetNumberOfContents (uint32_t numOfContents)
 {
-  if (m_requestMode != ZIPF_MANDELBROT)
-    return;
-
   m_N = numOfContents;
-
-  NS_LOG_DEBUG (m_q << " and " << m_s << " and " << m_N);
-
-  m_Pcum = std::vector<double> (m_N + 1);
-
-  m_Pcum[0] = 0.0;
-  for (uint32_t i=1; i<=m_N; i++)
-    {
-      m_Pcum[i] = m_Pcum[i-1] + 1.0 / std::pow(i+m_q, m_s);
-    }
-
-  for (uint32_t i=1; i<=m_N; i++)
-    {
-      m_Pcum[i] = m_Pcum[i] / m_Pcum[m_N];
-      NS_LOG_LOGIC ("Cumulative probability [" << i << "]=" << m_Pcum[i]);
-  }
+  m_zipf.reset (); // sampler will be rebuilt when it is needed
 }
 
 uint32_t
@@ -177,11 +160,8 @@ Consumer::GetNumberOfContents () const
 void
 Consumer::SetQ (double q)
 {
-  if (m_requestMode != ZIPF_MANDELBROT)
-    return;
-
   m_q = q;
-  SetNumberOfContents (m_N);
+  m_zipf.reset ();
 }
 
 double
@@ -193,11 +173,8 @@ Consumer::GetQ () const
 void
 Consumer::SetS (double s)
 {
-  if (m_requestMode != ZIPF_MANDELBROT)
-    return;
-
   m_s = s;
-  SetNumberOfContents (m_N);
+  m_zipf.reset ();
 }
 
 double
@@ -210,15 +187,6 @@ void
 Consumer::SetRetxTimer (Time retxTimer)
 {
   m_retxTimer = retxTimer;
-  if (m_retxEvent.IsRunning ())
-    {
-      // m_retxEvent.Cancel (); // cancel any scheduled cleanup events
-      Simulator::Remove (m_retxEvent); // slower, but better for memory
-    }
-
-  // schedule even with new timeout
-  m_retxEvent = Simulator::Schedule (m_retxTimer,
-                                     &Consumer::CheckRetxTimeout, this);
 }
 
 Time
@@ -227,30 +195,50 @@ Consumer::GetRetxTimer () const
   return m_retxTimer;
 }
 
+void
+Consumer::ScheduleRetxTimeout ()
+{
+  if (m_seqWindow.GetOutstandingCount () == 0)
+    return; // nothing to wait for (already scheduled check, if any, will not re-arm the timer)
+
+  Time deadline = m_seqWindow.GetLastSendTime (m_seqWindow.GetOldestOutstanding ()) + m_rtt->RetransmitTimeout ();
+  deadline = Max (deadline, m_lastRetxCheck + m_retxTimer);
+
+  if (m_retxEvent.IsRunning ())
+    {
+      if (Simulator::Now () + Simulator::GetDelayLeft (m_retxEvent) <= deadline)
+        return; // check is already scheduled before the deadline
+
+      m_retxEvent.Cancel ();
+    }
+
+  m_retxEvent = Simulator::Schedule (Max (deadline - Simulator::Now (), Seconds (0)),
+                                     &Consumer::CheckRetxTimeout, this);
+}
+
 void
 Consumer::CheckRetxTimeout ()
 {
   Time now = Simulator::Now ();
+  m_lastRetxCheck = now;
 
   Time rto = m_rtt->RetransmitTimeout ();
   // NS_LOG_DEBUG ("Current RTO: " << rto.ToDouble (Time::S) << "s");
 
-  while (!m_seqTimeouts.empty ())
+  while (m_seqWindow.GetOutstandingCount () > 0)
     {
-      SeqTimeoutsContainer::index<i_timestamp>::type::iterator entry =
-        m_seqTimeouts.get<i_timestamp> ().begin ();
-      if (entry->time + rto <= now) // timeout expired?
+      uint32_t slot = m_seqWindow.GetOldestOutstanding ();
+      if (m_seqWindow.GetLastSendTime (slot) + rto <= now) // timeout expired?
         {
-          uint32_t seqNo = entry->seq;
-          m_seqTimeouts.get<i_timestamp> ().erase (entry);
+          uint32_t seqNo = m_seqWindow.GetSeq (slot);
+          m_seqWindow.StopTimer (seqNo);
           OnTimeout (seqNo);
         }
       else
         break; // nothing else to do. All later packets need not be retransmitted
     }
 
-  m_retxEvent = Simulator::Schedule (m_retxTimer,
-                                     &Consumer::CheckRetxTimeout, this);
+  ScheduleRetxTimeout ();
 }
 
 // Application Methods
@@ -262,6 +250,12 @@ Consumer::StartApplication () // Called at time specified by Start
   // do base stuff
   App::StartApplication ();
 
+  if (m_requestMode == ZIPF_MANDELBROT && !m_zipf)
+    {
+      // all attributes are set by now, build (or get already built) sampler before any Interest is sent
+      m_zipf = ZipfMandelbrotSampler::Get (m_N, m_q, m_s);
+    }
+
   ScheduleNextPacket ();
 }
 
@@ -272,6 +266,7 @@ Consumer::StopApplication () // Called at time specified by Stop
 
   // cancel periodic packet generation
   Simulator::Cancel (m_sendEvent);
+  Simulator::Cancel (m_retxEvent);
 
   // cleanup base stuff
   App::StopApplication ();
@@ -309,8 +304,8 @@ Consumer::SendPacket ()
         }
       else
         {
-          NS_ASSERT_MSG (m_seqTimeouts.size () < GetNumberOfContents (), "Content catelog exhausted!!!");
-          while (m_seqTimeouts.count (seq = GetNextSeq ())); // do not send duplicate interest
+          NS_ASSERT_MSG (m_seqWindow.GetOutstandingCount () < GetNumberOfContents (), "Content catelog exhausted!!!");
+          while (m_seqWindow.IsOutstanding (seq = GetNextSeq ())); // do not send duplicate interest
         }
 
       m_seq ++;
@@ -358,28 +353,15 @@ Consumer::SendPacket ()
 }
 
 uint32_t
-Consumer::GetNextSeq()
+Consumer::GetNextSeq ()
 {
-  uint32_t content_index = 1; //[1, m_N]
-  double p_sum = 0;
-
-  double p_random = m_rand.GetValue(0.0, 1.0);
-  while (p_random == 0)
+  if (!m_zipf)
     {
-      p_random = m_rand.GetValue(0.0, 1.0);
+      NS_LOG_DEBUG (m_q << " and " << m_s << " and " << m_N);
+      m_zipf = ZipfMandelbrotSampler::Get (m_N, m_q, m_s);
     }
 
-  for (uint32_t i=1; i<=m_N; i++)
-    {
-      p_sum = m_Pcum[i];   //m_Pcum[i] = m_Pcum[i-1] + p[i], p[0] = 0;   e.g.: p_cum[1] = p[1], p_cum[2] = p[1] + p[2]
-      if (p_random <= p_sum)
-        {
-          content_index = i;
-          break;
-        } //if
-    } //for
-
-  return content_index;
+  return m_zipf->Sample (m_rand.GetValue (0.0, 1.0)); // [1, m_N]
 }
 
 ///////////////////////////////////////////////////
@@ -409,26 +391,21 @@ Consumer::OnContentObject (const Ptr<const ContentObject> &contentObject,
       hopCount = hopCountTag.Get ();
     }
 
-  SeqTimeoutsContainer::iterator entry = m_seqLastDelay.find (seq);
-  if (entry != m_seqLastDelay.end ())
-    {
-      m_lastRetransmittedInterestDataDelay (this, seq, Simulator::Now () - entry->time, hopCount);
-    }
-
-  entry = m_seqFullDelay.find (seq);
-  if (entry != m_seqFullDelay.end ())
+  uint32_t slot = m_seqWindow.Find (seq);
+  if (slot != SeqWindow::NONE)
     {
-      m_firstInterestDataDelay (this, seq, Simulator::Now () - entry->time, m_seqRetxCounts[seq], hopCount);
+      m_lastRetransmittedInterestDataDelay (this, seq, Simulator::Now () - m_seqWindow.GetLastSendTime (slot), hopCount);
+      m_firstInterestDataDelay (this, seq, Simulator::Now () - m_seqWindow.GetFirstSendTime (slot),
+                                m_seqWindow.GetTransmissionCount (slot), hopCount);
     }
 
-  m_seqRetxCounts.erase (seq);
-  m_seqFullDelay.erase (seq);
-  m_seqLastDelay.erase (seq);
-
-  m_seqTimeouts.erase (seq);
+  m_seqWindow.Erase (seq);
   m_retxSeqs.erase (seq);
 
   m_rtt->AckSeq (SequenceNumber32 (seq));
+
+  // RTO or the oldest outstanding Interest may have changed
+  ScheduleRetxTimeout ();
 }
 
 void
@@ -452,7 +429,7 @@ Consumer::OnNack (const Ptr<const Interest> &interest, Ptr<Packet> origPacket)
   m_retxSeqs.insert (seq);
   // NS_LOG_INFO ("After: " << m_retxSeqs.size ());
 
-  m_seqTimeouts.erase (seq);
+  m_seqWindow.StopTimer (seq);
 
 //  m_rtt->IncreaseMultiplier ();             // Double the next RTO ??
   ScheduleNextPacket ();
@@ -473,17 +450,17 @@ Consumer::OnTimeout (uint32_t sequenceNumber)
 void
 Consumer::WillSendOutInterest (uint32_t sequenceNumber)
 {
-  NS_LOG_DEBUG ("Trying to add " << sequenceNumber << " with " << Simulator::Now () << ". already " << m_seqTimeouts.size () << " items");
+  NS_LOG_DEBUG ("Trying to add " << sequenceNumber << " with " << Simulator::Now () << ". already " << m_seqWindow.GetOutstandingCount () << " items");
 
-  m_seqTimeouts.insert (SeqTimeout (sequenceNumber, Simulator::Now ()));
-  m_seqFullDelay.insert (SeqTimeout (sequenceNumber, Simulator::Now ()));
-
-  m_seqLastDelay.erase (sequenceNumber);
-  m_seqLastDelay.insert (SeqTimeout (sequenceNumber, Simulator::Now ()));
-
-  m_seqRetxCounts[sequenceNumber] ++;
+  m_seqWindow.Sent (sequenceNumber, Simulator::Now ());
 
   m_rtt->SentSeq (SequenceNumber32 (sequenceNumber), 1);
+
+  if (m_seqWindow.GetOutstandingCount () == 1 || !m_retxEvent.IsRunning ())
+    {
+      // the first outstanding Interest, otherwise the timer is already armed for an earlier deadline
+      ScheduleRetxTimeout ();
+    }
 }
 
 } // namespace ndn
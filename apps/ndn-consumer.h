@@ -28,18 +28,18 @@
 #include "ns3/nstime.h"
 #include "ns3/data-rate.h"
 #include "ns3/ndn-rtt-estimator.h"
+#include "ns3/ndn-seq-window.h"
 
 #include <set>
 #include <map>
 
-#include <boost/multi_index_container.hpp>
-#include <boost/multi_index/tag.hpp>
-#include <boost/multi_index/ordered_index.hpp>
-#include <boost/multi_index/member.hpp>
+#include <boost/shared_ptr.hpp>
 
 namespace ns3 {
 namespace ndn {
 
+class ZipfMandelbrotSampler;
+
 /**
  * @ingroup ndn
  * \brief NDN application for sending out Interest packets
@@ -117,15 +117,24 @@ protected:
   CheckRetxTimeout ();
 
   /**
-   * \brief Modifies the frequency of checking the retransmission timeouts
-   * \param retxTimer Timeout defining how frequent retransmission timeouts should be checked
+   * \brief Arm retransmission timer to the earliest deadline of outstanding Interests
+   *
+   * The timer is rescheduled only if the deadline is earlier than already scheduled check.  If the deadline
+   * moves later (e.g., Data for the oldest Interest arrived), the check fires early and re-arms the timer.
+   */
+  void
+  ScheduleRetxTimeout ();
+
+  /**
+   * \brief Modifies the minimum interval between checks of the retransmission timeouts
+   * \param retxTimer Minimum interval between checks of the retransmission timeouts
    */
   void
   SetRetxTimer (Time retxTimer);
 
   /**
-   * \brief Returns the frequency of checking the retransmission timeouts
-   * \return Timeout defining how frequent retransmission timeouts should be checked
+   * \brief Returns the minimum interval between checks of the retransmission timeouts
+   * \return Minimum interval between checks of the retransmission timeouts
    */
   Time
   GetRetxTimer () const;
@@ -144,7 +153,7 @@ protected:
   uint32_t        m_N;  ///< @brief total number of contents, Zipf-Mandelbrot only
   double          m_q;  ///< @brief q in (k+q)^s, Zipf-Mandelbrot only
   double          m_s;  ///< @brief s in (k+q)^s, Zipf-Mandelbrot only
-  std::vector<double> m_Pcum;  ///< @brief cumulative probability, Zipf-Mandelbrot only
+  boost::shared_ptr<const ZipfMandelbrotSampler> m_zipf; ///< @brief sampler of content ranks (built on demand, shared between consumers), Zipf-Mandelbrot only
 
   void
   SetNumberOfContents (uint32_t numOfContents);
@@ -168,8 +177,9 @@ protected:
   GetNextSeq();
 
   EventId         m_sendEvent; ///< @brief EventId of pending "send packet" event
-  Time            m_retxTimer; ///< @brief Currently estimated retransmission timer
+  Time            m_retxTimer; ///< @brief Minimum interval between checks of the retransmission timeouts
   EventId         m_retxEvent; ///< @brief Event to check whether or not retransmission should be performed
+  Time            m_lastRetxCheck; ///< @brief Time of the last check of the retransmission timeouts
 
   Ptr<RttEstimator> m_rtt; ///< @brief RTT estimator
 
@@ -188,49 +198,11 @@ protected:
     public std::set<uint32_t> { };
 
   RetxSeqsContainer m_retxSeqs;             ///< \brief ordered set of sequence numbers to be retransmitted
-
-  /**
-   * \struct This struct contains a pair of packet sequence number and its timeout
-   */
-  struct SeqTimeout
-  {
-    SeqTimeout (uint32_t _seq, Time _time) : seq (_seq), time (_time) { }
-
-    uint32_t seq;
-    Time time;
-  };
 /// @endcond
 
-/// @cond include_hidden
-  class i_seq { };
-  class i_timestamp { };
-/// @endcond
+  SeqWindow m_seqWindow; ///< \brief transmission times and counts of requested sequence numbers, and timeouts of outstanding ones
 
 /// @cond include_hidden
-  /**
-   * \struct This struct contains a multi-index for the set of SeqTimeout structs
-   */
-  struct SeqTimeoutsContainer :
-    public boost::multi_index::multi_index_container<
-    SeqTimeout,
-    boost::multi_index::indexed_by<
-      boost::multi_index::ordered_unique<
-        boost::multi_index::tag<i_seq>,
-        boost::multi_index::member<SeqTimeout, uint32_t, &SeqTimeout::seq>
-        >,
-      boost::multi_index::ordered_non_unique<
-        boost::multi_index::tag<i_timestamp>,
-        boost::multi_index::member<SeqTimeout, Time, &SeqTimeout::time>
-        >
-      >
-    > { } ;
-
-  SeqTimeoutsContainer m_seqTimeouts;       ///< \brief multi-index for the set of SeqTimeout structs
-
-  SeqTimeoutsContainer m_seqLastDelay;
-  SeqTimeoutsContainer m_seqFullDelay;
-  std::map<uint32_t, uint32_t> m_seqRetxCounts;
-
   TracedCallback<Ptr<App> /* app */, uint32_t /* seqno */,
                  Time /* delay */, int32_t /*hop count*/> m_lastRetransmittedInterestDataDelay;
   TracedCallback<Ptr<App> /* app */, uint32_t /* seqno */,
@@ -28,6 +28,7 @@
 #include <boost/graph/properties.hpp>
 #include <boost/ref.hpp>
 
+#include "ns3/assert.h"
 #include "ns3/ndn-face.h"
 #include "ns3/ndn-limits.h"
 #include "ns3/node-list.h"
@@ -35,6 +36,10 @@
 #include "../model/ndn-global-router.h"
 #include <list>
 #include <map>
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <limits>
 
 namespace boost {
 
@@ -291,17 +296,6 @@ get(vertex_index_t,
   return VertexIds (g);
 }
 
-template<class M, class K, class V>
-inline void
-put (reference_wrapper< M > mapp,
-     K a, V p)
-{
-  mapp.get ()[a] = p;
-}
-
-// void
-// put (cref< std::map< ns3::Ptr<ns3::ndn::GlobalRouter>, ns3::Ptr<ns3::ndn::GlobalRouter> > > map,
-
 inline uint32_t
 get (const boost::VertexIds&, ns3::Ptr<ns3::ndn::GlobalRouter> &gr)
 {
@@ -325,46 +319,478 @@ get(const boost::EdgeWeights&, ns3::ndn::GlobalRouter::Incidency &edge)
     }
 }
 
-struct PredecessorsMap :
-    public std::map< ns3::Ptr< ns3::ndn::GlobalRouter >, ns3::Ptr< ns3::ndn::GlobalRouter > >
-{
-};
+//////////////////////////////////////////////////////////////
+// Snapshot of the graph
 
-template<>
-struct property_traits< reference_wrapper<PredecessorsMap> >
+/**
+ * @brief Read-only copy of the router graph in compressed sparse row (CSR) form
+ *
+ * Vertices are indexed by GlobalRouter::GetId ().  Out edges of vertex `v` are stored contiguously
+ * in m_edges[m_offsets[v]...m_offsets[v+1]).
+ *
+ * Snapshot contains only plain data (vertex and face indexes, metrics, and delays), so after it is created
+ * on the main thread, route calculation does not need to copy Ptr<> or call methods of ns-3 objects.
+ * Therefore, the same snapshot can be safely used by several threads at the same time.
+ */
+class NdnGlobalRouterGraphSnapshot
 {
-  // Metric property map
-  typedef ns3::Ptr< ns3::ndn::GlobalRouter > value_type;
-  typedef ns3::Ptr< ns3::ndn::GlobalRouter > reference;
-  typedef ns3::Ptr< ns3::ndn::GlobalRouter > key_type;
-  typedef read_write_property_map_tag category;
-};
+public:
+  static const uint32_t NO_FACE = 0xFFFFFFFF;
+  static const uint32_t NO_VERTEX = 0xFFFFFFFF;
 
+  struct Edge
+  {
+    uint32_t m_target; ///< @brief index of the target vertex
+    uint32_t m_face;   ///< @brief index of the face (NO_FACE if edge is not associated with any face)
+    uint32_t m_metric; ///< @brief routing metric of the edge
+    double   m_delay;  ///< @brief propagation delay of the edge
+  };
+
+  typedef std::vector<Edge>::const_iterator edge_iterator;
+
+  /**
+   * @brief Create snapshot of the graph
+   */
+  explicit
+  NdnGlobalRouterGraphSnapshot (const NdnGlobalRouterGraph &graph)
+  {
+    uint32_t nVertices = 0;
+    for (std::list< NdnGlobalRouterGraph::Vertice >::const_iterator vertex = graph.GetVertices ().begin ();
+         vertex != graph.GetVertices ().end ();
+         vertex++)
+      {
+        nVertices = std::max (nVertices, (*vertex)->GetId () + 1);
+      }
 
-struct DistancesMap :
-  public std::map< ns3::Ptr< ns3::ndn::GlobalRouter >, tuple< ns3::Ptr<ns3::ndn::Face>, uint32_t, double > >
-{
-};
+    m_vertices.resize (nVertices);
+    m_offsets.assign (nVertices + 1, 0);
+    for (std::list< NdnGlobalRouterGraph::Vertice >::const_iterator vertex = graph.GetVertices ().begin ();
+         vertex != graph.GetVertices ().end ();
+         vertex++)
+      {
+        m_vertices[(*vertex)->GetId ()] = *vertex;
+        m_offsets[(*vertex)->GetId () + 1] = (*vertex)->GetIncidencies ().size ();
+      }
 
-template<>
-struct property_traits< reference_wrapper<DistancesMap> >
-{
-  // Metric property map
-  typedef tuple< ns3::Ptr<ns3::ndn::Face>, uint32_t, double > value_type;
-  typedef tuple< ns3::Ptr<ns3::ndn::Face>, uint32_t, double > reference;
-  typedef ns3::Ptr< ns3::ndn::GlobalRouter > key_type;
-  typedef read_write_property_map_tag category;
+    for (uint32_t v = 0; v < nVertices; v++)
+      {
+        m_offsets[v + 1] += m_offsets[v];
+      }
+
+    m_edges.resize (m_offsets[nVertices]);
+    for (uint32_t v = 0; v < nVertices; v++)
+      {
+        if (m_vertices[v] == 0)
+          continue;
+
+        std::vector<Edge>::iterator edge = m_edges.begin () + m_offsets[v];
+
+        ns3::ndn::GlobalRouter::IncidencyList &incidencies = m_vertices[v]->GetIncidencies ();
+        for (ns3::ndn::GlobalRouter::IncidencyList::iterator incidency = incidencies.begin ();
+             incidency != incidencies.end ();
+             incidency++, edge++)
+          {
+            property_traits< EdgeWeights >::reference weight = get (EdgeWeights (graph), *incidency);
+
+            edge->m_target = incidency->get<2> ()->GetId ();
+            edge->m_face   = NO_FACE;
+            edge->m_metric = weight.get<1> ();
+            edge->m_delay  = weight.get<2> ();
+
+            if (weight.get<0> () != 0)
+              {
+                std::map< ns3::Ptr<ns3::ndn::Face>, uint32_t >::iterator face = m_faceIndex.find (weight.get<0> ());
+                if (face == m_faceIndex.end ())
+                  {
+                    face = m_faceIndex.insert (std::make_pair (weight.get<0> (), m_faces.size ())).first;
+                    m_faces.push_back (weight.get<0> ());
+                    m_faceIds.push_back (weight.get<0> ()->GetId ());
+                  }
+                edge->m_face = face->second;
+              }
+          }
+      }
+  }
+
+  /**
+   * @brief Create reversed copy of the snapshot (edge u->v becomes v->u)
+   *
+   * Edges over faces excludedFace1 and excludedFace2 are not included in the reversed copy
+   */
+  NdnGlobalRouterGraphSnapshot (const NdnGlobalRouterGraphSnapshot &graph,
+                                uint32_t excludedFace1, uint32_t excludedFace2)
+    : m_vertices (graph.m_vertices)
+    , m_faces (graph.m_faces)
+    , m_faceIds (graph.m_faceIds)
+    , m_faceIndex (graph.m_faceIndex)
+  {
+    uint32_t nVertices = m_vertices.size ();
+
+    m_offsets.assign (nVertices + 1, 0);
+    for (std::vector<Edge>::const_iterator edge = graph.m_edges.begin (); edge != graph.m_edges.end (); edge++)
+      {
+        if (edge->m_face != NO_FACE && (edge->m_face == excludedFace1 || edge->m_face == excludedFace2))
+          continue;
+        m_offsets[edge->m_target + 1] ++;
+      }
+
+    for (uint32_t v = 0; v < nVertices; v++)
+      {
+        m_offsets[v + 1] += m_offsets[v];
+      }
+
+    m_edges.resize (m_offsets[nVertices]);
+    std::vector<uint32_t> position (m_offsets.begin (), m_offsets.end () - 1);
+    for (uint32_t v = 0; v < nVertices; v++)
+      {
+        for (edge_iterator edge = graph.BeginEdges (v); edge != graph.EndEdges (v); edge++)
+          {
+            if (edge->m_face != NO_FACE && (edge->m_face == excludedFace1 || edge->m_face == excludedFace2))
+              continue;
+
+            Edge &reversed = m_edges[position[edge->m_target]++];
+            reversed = *edge;
+            reversed.m_target = v;
+          }
+      }
+  }
+
+  /**
+   * @brief Get number of vertex indexes (some indexes may not correspond to any vertex)
+   */
+  uint32_t
+  GetNVertices () const
+  {
+    return m_vertices.size ();
+  }
+
+  /**
+   * @brief Get index of the vertex
+   */
+  uint32_t
+  GetIndex (ns3::Ptr<ns3::ndn::GlobalRouter> vertex) const
+  {
+    NS_ASSERT (vertex->GetId () < m_vertices.size () && m_vertices[vertex->GetId ()] == vertex);
+    return vertex->GetId ();
+  }
+
+  /**
+   * @brief Get index of the face (NO_FACE if face is not part of the graph)
+   */
+  uint32_t
+  GetFaceIndex (ns3::Ptr<ns3::ndn::Face> face) const
+  {
+    std::map< ns3::Ptr<ns3::ndn::Face>, uint32_t >::const_iterator i = m_faceIndex.find (face);
+    if (i == m_faceIndex.end ())
+      return NO_FACE;
+    return i->second;
+  }
+
+  inline edge_iterator
+  BeginEdges (uint32_t vertex) const
+  {
+    return m_edges.begin () + m_offsets[vertex];
+  }
+
+  inline edge_iterator
+  EndEdges (uint32_t vertex) const
+  {
+    return m_edges.begin () + m_offsets[vertex + 1];
+  }
+
+public:
+  std::vector< ns3::Ptr<ns3::ndn::GlobalRouter> > m_vertices; ///< @brief vertex index -> router (0 if there is no such vertex)
+  std::vector< uint32_t > m_offsets;                          ///< @brief vertex index -> position of the first out edge
+  std::vector< Edge > m_edges;                                ///< @brief out edges of all vertices
+  std::vector< ns3::Ptr<ns3::ndn::Face> > m_faces;            ///< @brief face index -> face
+  std::vector< uint32_t > m_faceIds;                          ///< @brief face index -> face ID on its node
+
+private:
+  std::map< ns3::Ptr<ns3::ndn::Face>, uint32_t > m_faceIndex;
 };
 
-inline tuple< ns3::Ptr<ns3::ndn::Face>, uint32_t, double >
-get (DistancesMap &map, ns3::Ptr<ns3::ndn::GlobalRouter> key)
+/**
+ * @brief Dijkstra shortest path calculation on the graph snapshot
+ *
+ * Distance of each vertex is the triple of first-hop face, routing metric, and propagation delay.
+ * Distances and predecessors are kept in plain vectors indexed by vertex index.  Object keeps all
+ * working memory, so it should be reused for all calculations performed by the same thread (then
+ * nothing is allocated during the calculation).
+ */
+class NdnGlobalRouterDijkstra
 {
-  boost::DistancesMap::iterator i = map.find (key);
-  if (i == map.end ())
-    return tuple< ns3::Ptr<ns3::ndn::Face>, uint32_t, double > (0, std::numeric_limits<uint32_t>::max (), 0.0);
-  else
-    return i->second;
-}
+public:
+  struct Distance
+  {
+    uint32_t m_face;   ///< @brief index of the first-hop face (NO_FACE if vertex is not reachable)
+    uint32_t m_metric; ///< @brief total routing metric
+    double   m_delay;  ///< @brief total propagation delay
+  };
+
+  NdnGlobalRouterDijkstra (const NdnGlobalRouterGraphSnapshot &graph)
+    : m_graph (graph)
+    , m_distances (graph.GetNVertices ())
+    , m_predecessors (graph.GetNVertices ())
+    , m_enter (graph.GetNVertices ())
+    , m_exit (graph.GetNVertices ())
+  {
+  }
+
+  /**
+   * @brief Calculate distances from the source to all vertices
+   * @param source Index of the source vertex
+   */
+  void
+  Run (uint32_t source)
+  {
+    Distance infinity = { NdnGlobalRouterGraphSnapshot::NO_FACE, std::numeric_limits<uint32_t>::max (), 0.0 };
+    std::fill (m_distances.begin (), m_distances.end (), infinity);
+    std::fill (m_predecessors.begin (), m_predecessors.end (), static_cast<uint32_t> (NdnGlobalRouterGraphSnapshot::NO_VERTEX));
+
+    m_distances[source].m_metric = 0;
+
+    m_queue.clear ();
+    m_queue.push_back (QueueItem (0, source));
+    while (!m_queue.empty ())
+      {
+        std::pop_heap (m_queue.begin (), m_queue.end (), std::greater<QueueItem> ());
+        QueueItem item = m_queue.back ();
+        m_queue.pop_back ();
+
+        const Distance &distance = m_distances[item.second];
+        if (item.first > distance.m_metric)
+          continue; // outdated record
+
+        for (NdnGlobalRouterGraphSnapshot::edge_iterator edge = m_graph.BeginEdges (item.second);
+             edge != m_graph.EndEdges (item.second);
+             edge++)
+          {
+            uint32_t metric = distance.m_metric + edge->m_metric;
+            if (metric < m_distances[edge->m_target].m_metric)
+              {
+                Distance &target = m_distances[edge->m_target];
+                target.m_face   = (distance.m_face == NdnGlobalRouterGraphSnapshot::NO_FACE) ? edge->m_face : distance.m_face;
+                target.m_metric = metric;
+                target.m_delay  = distance.m_delay + edge->m_delay;
+                m_predecessors[edge->m_target] = item.second;
+
+                m_queue.push_back (QueueItem (metric, edge->m_target));
+                std::push_heap (m_queue.begin (), m_queue.end (), std::greater<QueueItem> ());
+              }
+          }
+      }
+  }
+
+  /**
+   * @brief Calculate distances from the source of `tree' that avoid `excludedVertex', for vertices in its subtree
+   *
+   * Shortest paths of vertices outside of the subtree of excludedVertex do not go through it, so their
+   * distances in `tree' stay the same.  Vertices of the subtree are seeded from the edges leaving the subtree
+   * (with distances from `tree'), and the search is limited to the subtree, so the cost is proportional to
+   * the size of the subtree, not of the whole graph.  After the call, distances are valid only for vertices
+   * of the subtree (except excludedVertex itself).
+   *
+   * @param tree           result of Run on the same graph, followed by NumberTree
+   * @param inEdges        graph with edges reversed relative to the graph of this object (i.e., incoming edges of each vertex)
+   * @param excludedVertex vertex that is removed from the graph
+   */
+  void
+  RunInSubtree (const NdnGlobalRouterDijkstra &tree, const NdnGlobalRouterGraphSnapshot &inEdges, uint32_t excludedVertex)
+  {
+    Distance infinity = { NdnGlobalRouterGraphSnapshot::NO_FACE, std::numeric_limits<uint32_t>::max (), 0.0 };
+
+    // vertices of the subtree (excluding its root) in breadth-first order
+    m_subtree.clear ();
+    for (uint32_t child = tree.m_childOffsets[excludedVertex]; child < tree.m_childOffsets[excludedVertex + 1]; child++)
+      m_subtree.push_back (tree.m_children[child]);
+    for (uint32_t i = 0; i < m_subtree.size (); i++)
+      {
+        uint32_t v = m_subtree[i];
+        for (uint32_t child = tree.m_childOffsets[v]; child < tree.m_childOffsets[v + 1]; child++)
+          m_subtree.push_back (tree.m_children[child]);
+      }
+
+    m_queue.clear ();
+    for (std::vector<uint32_t>::const_iterator v = m_subtree.begin (); v != m_subtree.end (); v++)
+      {
+        Distance &distance = m_distances[*v];
+        distance = infinity;
+        m_predecessors[*v] = NdnGlobalRouterGraphSnapshot::NO_VERTEX;
+
+        // edges from vertices outside of the subtree (their distances do not change)
+        for (NdnGlobalRouterGraphSnapshot::edge_iterator edge = inEdges.BeginEdges (*v);
+             edge != inEdges.EndEdges (*v);
+             edge++)
+          {
+            if (!tree.IsReachable (edge->m_target) || tree.IsAncestor (excludedVertex, edge->m_target))
+              continue;
+
+            const Distance &outside = tree.GetDistance (edge->m_target);
+            uint32_t metric = outside.m_metric + edge->m_metric;
+            if (metric < distance.m_metric)
+              {
+                distance.m_face   = (outside.m_face == NdnGlobalRouterGraphSnapshot::NO_FACE) ? edge->m_face : outside.m_face;
+                distance.m_metric = metric;
+                distance.m_delay  = outside.m_delay + edge->m_delay;
+                m_predecessors[*v] = edge->m_target;
+              }
+          }
+
+        if (IsReachable (*v))
+          m_queue.push_back (QueueItem (distance.m_metric, *v));
+      }
+    std::make_heap (m_queue.begin (), m_queue.end (), std::greater<QueueItem> ());
+
+    while (!m_queue.empty ())
+      {
+        std::pop_heap (m_queue.begin (), m_queue.end (), std::greater<QueueItem> ());
+        QueueItem item = m_queue.back ();
+        m_queue.pop_back ();
+
+        const Distance &distance = m_distances[item.second];
+        if (item.first > distance.m_metric)
+          continue; // outdated record
+
+        for (NdnGlobalRouterGraphSnapshot::edge_iterator edge = m_graph.BeginEdges (item.second);
+             edge != m_graph.EndEdges (item.second);
+             edge++)
+          {
+            if (edge->m_target == excludedVertex || !tree.IsReachable (edge->m_target) ||
+                !tree.IsAncestor (excludedVertex, edge->m_target))
+              continue; // only vertices of the subtree can get shorter
+
+            uint32_t metric = distance.m_metric + edge->m_metric;
+            if (metric < m_distances[edge->m_target].m_metric)
+              {
+                Distance &target = m_distances[edge->m_target];
+                target.m_face   = distance.m_face;
+                target.m_metric = metric;
+                target.m_delay  = distance.m_delay + edge->m_delay;
+                m_predecessors[edge->m_target] = item.second;
+
+                m_queue.push_back (QueueItem (metric, edge->m_target));
+                std::push_heap (m_queue.begin (), m_queue.end (), std::greater<QueueItem> ());
+              }
+          }
+      }
+  }
+
+  /**
+   * @brief Get distance to the vertex, calculated by the last Run
+   */
+  const Distance &
+  GetDistance (uint32_t vertex) const
+  {
+    return m_distances[vertex];
+  }
+
+  /**
+   * @brief Check if vertex was reachable from the source in the last Run
+   */
+  bool
+  IsReachable (uint32_t vertex) const
+  {
+    return m_distances[vertex].m_metric != std::numeric_limits<uint32_t>::max ();
+  }
+
+  /**
+   * @brief Get predecessor of the vertex on the shortest path (NO_VERTEX for the source and unreachable vertices)
+   */
+  uint32_t
+  GetPredecessor (uint32_t vertex) const
+  {
+    return m_predecessors[vertex];
+  }
+
+  /**
+   * @brief Number vertices of the shortest path tree, calculated by the last Run, in depth-first order
+   *
+   * Has to be called before IsAncestor
+   */
+  void
+  NumberTree ()
+  {
+    uint32_t nVertices = m_graph.GetNVertices ();
+
+    // children of each vertex in CSR form (m_queue is reused as scratch space)
+    m_childOffsets.assign (nVertices + 1, 0);
+    for (uint32_t v = 0; v < nVertices; v++)
+      {
+        if (m_predecessors[v] != NdnGlobalRouterGraphSnapshot::NO_VERTEX)
+          m_childOffsets[m_predecessors[v] + 1] ++;
+      }
+    for (uint32_t v = 0; v < nVertices; v++)
+      {
+        m_childOffsets[v + 1] += m_childOffsets[v];
+      }
+    m_children.resize (m_childOffsets[nVertices]);
+    std::vector<uint32_t> &position = m_exit; // reused before actual exit numbers are assigned
+    std::copy (m_childOffsets.begin (), m_childOffsets.end () - 1, position.begin ());
+    for (uint32_t v = 0; v < nVertices; v++)
+      {
+        if (m_predecessors[v] != NdnGlobalRouterGraphSnapshot::NO_VERTEX)
+          m_children[position[m_predecessors[v]]++] = v;
+      }
+
+    // vertices outside the tree are never ancestors of tree vertices
+    std::fill (m_enter.begin (), m_enter.end (), std::numeric_limits<uint32_t>::max ());
+    std::fill (m_exit.begin (), m_exit.end (), 0);
+
+    uint32_t counter = 0;
+    m_queue.clear ();
+    for (uint32_t root = 0; root < nVertices; root++)
+      {
+        if (m_predecessors[root] != NdnGlobalRouterGraphSnapshot::NO_VERTEX || !IsReachable (root))
+          continue;
+
+        // (vertex, number of already visited children)
+        m_queue.push_back (QueueItem (root, 0));
+        m_enter[root] = counter++;
+        while (!m_queue.empty ())
+          {
+            QueueItem &item = m_queue.back ();
+            uint32_t child = m_childOffsets[item.first] + item.second;
+            if (child == m_childOffsets[item.first + 1])
+              {
+                m_exit[item.first] = counter++;
+                m_queue.pop_back ();
+                continue;
+              }
+
+            item.second ++;
+            m_enter[m_children[child]] = counter++;
+            m_queue.push_back (QueueItem (m_children[child], 0));
+          }
+      }
+  }
+
+  /**
+   * @brief Check if `ancestor' lies on the tree path from the source of the last Run to `vertex'
+   *
+   * Vertex is considered its own ancestor.  NumberTree must be called after the last Run.
+   */
+  inline bool
+  IsAncestor (uint32_t ancestor, uint32_t vertex) const
+  {
+    return m_enter[ancestor] <= m_enter[vertex] && m_exit[vertex] <= m_exit[ancestor];
+  }
+
+private:
+  typedef std::pair<uint32_t, uint32_t> QueueItem; ///< @brief (metric, vertex), ties are resolved by vertex index
+
+  const NdnGlobalRouterGraphSnapshot &m_graph;
+  std::vector<Distance> m_distances;
+  std::vector<uint32_t> m_predecessors;
+  std::vector<QueueItem> m_queue;
+
+  // shortest path tree numbering (NumberTree)
+  std::vector<uint32_t> m_enter;
+  std::vector<uint32_t> m_exit;
+  std::vector<uint32_t> m_childOffsets;
+  std::vector<uint32_t> m_children;
+
+  std::vector<uint32_t> m_subtree; ///< @brief scratch space for RunInSubtree
+};
 
 } // namespace boost
 
@@ -37,16 +37,21 @@
 #include "ns3/channel-list.h"
 #include "ns3/object-factory.h"
 
+#ifdef NS3_MT
+#include "ns3/system-thread.h"
+#include "ns3/system-mutex.h"
+#endif
+
 #include <boost/lexical_cast.hpp>
 #include <boost/foreach.hpp>
-#include <boost/concept/assert.hpp>
-// #include <boost/graph/graph_concepts.hpp>
-// #include <boost/graph/adjacency_list.hpp>
-#include <boost/graph/dijkstra_shortest_paths.hpp>
 
 #include "boost-graph-ndn-global-routing-helper.h"
 
 #include <math.h>
+#include <vector>
+#include <functional>
+#include <fstream>
+#include <sstream>
 
 NS_LOG_COMPONENT_DEFINE ("ndn.GlobalRoutingHelper");
 
@@ -56,6 +61,432 @@ using namespace boost;
 namespace ns3 {
 namespace ndn {
 
+uint32_t GlobalRoutingHelper::m_numberOfThreads = 1;
+uint32_t GlobalRoutingHelper::m_maxNextHops = 0;
+bool GlobalRoutingHelper::m_loopFreeNextHopsOnly = false;
+std::string GlobalRoutingHelper::m_routeCacheFile;
+bool GlobalRoutingHelper::m_prefixAggregation = false;
+bool GlobalRoutingHelper::m_allPossibleRoutes = false;
+
+/// @cond include_hidden
+/**
+ * @brief Calculates routes for a share of source nodes or prefix origins (one worker per thread)
+ *
+ * Workers take tasks (sources or origins) one by one from the common job, until all tasks are processed.
+ * Workers use only read-only graph snapshots and write results to the task's own slot,
+ * so only taking the next task needs synchronization.
+ */
+class GlobalRoutingWorker
+{
+public:
+  struct Route
+  {
+    uint32_t m_origin; ///< @brief vertex index of the origin node
+    uint32_t m_face;   ///< @brief face index of the first hop
+    uint32_t m_metric;
+    double   m_delay;
+  };
+
+  typedef std::vector<Route> RouteList;
+  typedef std::vector< std::pair<uint32_t, Route> > SourceRouteList; ///< @brief (source number, route)
+
+  struct Job
+  {
+    Job (const NdnGlobalRouterGraphSnapshot &graph, bool allPossibleRoutes, bool loopFreeOnly, bool detours)
+      : m_graph (graph)
+      , m_reversedGraph (0)
+      , m_allPossibleRoutes (allPossibleRoutes)
+      , m_loopFreeOnly (loopFreeOnly)
+      , m_detours (detours)
+      , m_nextTask (0)
+    {
+    }
+
+    const NdnGlobalRouterGraphSnapshot &m_graph;
+    const NdnGlobalRouterGraphSnapshot *m_reversedGraph; ///< @brief reversed graph (only to calculate all possible routes)
+    bool m_allPossibleRoutes;
+    bool m_loopFreeOnly;
+    bool m_detours; ///< @brief use faces towards neighbors, whose shortest paths lead back through the source (all possible routes)
+
+    std::vector<uint32_t> m_sources;  ///< @brief vertex indexes of nodes for which routes are calculated
+    std::vector<uint32_t> m_origins;  ///< @brief vertex indexes of nodes that export prefixes
+    std::vector<RouteList> m_routes;  ///< @brief calculated routes for each source
+    std::vector<SourceRouteList> m_originRoutes; ///< @brief calculated routes to each origin (all possible routes)
+
+#ifdef NS3_MT
+    SystemMutex m_mutex;
+#endif
+    uint32_t m_nextTask;
+  };
+
+  /**
+   * @brief Calculate all routes of the job using the given number of threads
+   *
+   * After the call, m_routes contains routes of each source
+   */
+  static void
+  RunAll (Job &job, uint32_t numberOfThreads)
+  {
+    if (job.m_allPossibleRoutes)
+      {
+        job.m_reversedGraph = new NdnGlobalRouterGraphSnapshot (job.m_graph,
+                                                                NdnGlobalRouterGraphSnapshot::NO_FACE,
+                                                                NdnGlobalRouterGraphSnapshot::NO_FACE);
+        job.m_originRoutes.resize (job.m_origins.size ());
+      }
+
+    uint32_t nTasks = job.m_allPossibleRoutes ? job.m_origins.size () : job.m_sources.size ();
+    numberOfThreads = std::min<uint32_t> (numberOfThreads, nTasks);
+#ifndef NS3_MT
+    numberOfThreads = 1; // ns-3 is built without threading support
+#endif
+    if (numberOfThreads <= 1)
+      {
+        GlobalRoutingWorker worker (job);
+        worker.Run ();
+      }
+#ifdef NS3_MT
+    else
+      {
+        NS_LOG_DEBUG ("Calculating routes using " << numberOfThreads << " threads");
+
+        std::vector< GlobalRoutingWorker* > workers;
+        std::vector< Ptr<SystemThread> > threads;
+        for (uint32_t i = 0; i < numberOfThreads; i++)
+          {
+            workers.push_back (new GlobalRoutingWorker (job));
+            threads.push_back (Create<SystemThread> (MakeCallback (&GlobalRoutingWorker::Run, workers.back ())));
+            threads.back ()->Start ();
+          }
+
+        for (uint32_t i = 0; i < numberOfThreads; i++)
+          {
+            threads[i]->Join ();
+            delete workers[i];
+          }
+      }
+#endif
+
+    delete job.m_reversedGraph;
+    job.m_reversedGraph = 0;
+
+    // group routes by sources, in the order of origins
+    for (uint32_t originNo = 0; originNo < job.m_originRoutes.size (); originNo++)
+      {
+        BOOST_FOREACH (const SourceRouteList::value_type &route, job.m_originRoutes[originNo])
+          {
+            job.m_routes[route.first].push_back (route.second);
+          }
+        SourceRouteList ().swap (job.m_originRoutes[originNo]); // release memory
+      }
+  }
+
+  GlobalRoutingWorker (Job &job)
+    : m_job (job)
+    , m_dijkstra (job.m_allPossibleRoutes ? *job.m_reversedGraph : job.m_graph)
+    , m_detour (job.m_allPossibleRoutes ? *job.m_reversedGraph : job.m_graph)
+  {
+  }
+
+  void
+  Run ()
+  {
+    uint32_t nTasks = m_job.m_allPossibleRoutes ? m_job.m_origins.size () : m_job.m_sources.size ();
+    while (true)
+      {
+        uint32_t taskNo;
+        {
+#ifdef NS3_MT
+          CriticalSection lock (m_job.m_mutex);
+#endif
+          if (m_job.m_nextTask >= nTasks)
+            return;
+
+          taskNo = m_job.m_nextTask ++;
+        }
+
+        if (m_job.m_allPossibleRoutes)
+          CalculateToOrigin (taskNo);
+        else
+          CalculateFromSource (taskNo);
+      }
+  }
+
+private:
+  /**
+   * @brief Calculate shortest path tree from the source and collect best routes to all origins
+   */
+  void
+  CalculateFromSource (uint32_t sourceNo)
+  {
+    uint32_t source = m_job.m_sources[sourceNo];
+    RouteList &routes = m_job.m_routes[sourceNo];
+
+    m_dijkstra.Run (source);
+
+    for (std::vector<uint32_t>::const_iterator origin = m_job.m_origins.begin ();
+         origin != m_job.m_origins.end ();
+         origin++)
+      {
+        if (*origin == source)
+          continue;
+
+        const NdnGlobalRouterDijkstra::Distance &distance = m_dijkstra.GetDistance (*origin);
+        if (distance.m_face == NdnGlobalRouterGraphSnapshot::NO_FACE)
+          continue; // unreachable
+
+        Route route = { *origin, distance.m_face, distance.m_metric, distance.m_delay };
+        routes.push_back (route);
+      }
+  }
+
+  /**
+   * @brief Calculate routes via every face of every source to the origin
+   *
+   * One shortest path tree towards the origin (Dijkstra on the reversed graph) gives distances from all
+   * neighbors of all sources.  The best route via a face is the face metric plus distance from the neighbor.
+   * If the neighbor's shortest path goes back through the source, the distance of the shortest path that
+   * avoids the source is used instead, unless detours are disabled.  Only distances of the source's subtree
+   * of the shortest path tree can change when the source is avoided, so they are recalculated by a Dijkstra
+   * limited to the subtree (only for sources that have such neighbors).  If only loop-free next hops are requested, next hops that are not closer to the
+   * origin than the source itself are not used.
+   */
+  void
+  CalculateToOrigin (uint32_t originNo)
+  {
+    uint32_t origin = m_job.m_origins[originNo];
+    SourceRouteList &routes = m_job.m_originRoutes[originNo];
+
+    m_dijkstra.Run (origin);
+    m_dijkstra.NumberTree ();
+
+    for (uint32_t sourceNo = 0; sourceNo < m_job.m_sources.size (); sourceNo++)
+      {
+        uint32_t source = m_job.m_sources[sourceNo];
+        if (source == origin || !m_dijkstra.IsReachable (source))
+          continue;
+
+        uint32_t sourceMetric = m_dijkstra.GetDistance (source).m_metric;
+        bool detourCalculated = false;
+
+        for (NdnGlobalRouterGraphSnapshot::edge_iterator edge = m_job.m_graph.BeginEdges (source);
+             edge != m_job.m_graph.EndEdges (source);
+             edge++)
+          {
+            if (edge->m_face == NdnGlobalRouterGraphSnapshot::NO_FACE ||
+                !m_dijkstra.IsReachable (edge->m_target))
+              continue;
+
+            const NdnGlobalRouterDijkstra::Distance *distance = &m_dijkstra.GetDistance (edge->m_target);
+            if (edge->m_target != origin && m_dijkstra.IsAncestor (source, edge->m_target))
+              {
+                // neighbor's shortest path loops back through the source
+                if (!m_job.m_detours)
+                  continue;
+
+                if (!detourCalculated)
+                  {
+                    m_detour.RunInSubtree (m_dijkstra, m_job.m_graph, source);
+                    detourCalculated = true;
+                  }
+
+                if (!m_detour.IsReachable (edge->m_target))
+                  continue; // neighbor cannot reach the origin without the source
+                distance = &m_detour.GetDistance (edge->m_target);
+              }
+
+            if (m_job.m_loopFreeOnly && distance->m_metric >= sourceMetric)
+              continue; // neighbor is not closer to the origin
+
+            Route route = { origin, edge->m_face, distance->m_metric + edge->m_metric, distance->m_delay + edge->m_delay };
+            routes.push_back (std::make_pair (sourceNo, route));
+          }
+      }
+  }
+
+private:
+  Job &m_job;
+  NdnGlobalRouterDijkstra m_dijkstra;
+  NdnGlobalRouterDijkstra m_detour; ///< @brief shortest paths towards the origin that avoid the source (all possible routes)
+};
+
+/**
+ * @brief Persistent cache of calculated routes
+ *
+ * Cache file contains calculated routes of all sources, together with the hash of everything that routes depend on:
+ * graph structure, face IDs, metrics and delays, origins and their prefixes, and routing options.  If the hash
+ * of the current graph matches the one in the file, routes are loaded from the file instead of being calculated.
+ *
+ * The file is written in the host byte order and is intended to be reused on the same machine (e.g.,
+ * between replications of a simulation).
+ */
+class GlobalRoutingCache
+{
+public:
+  static uint64_t
+  Hash (const GlobalRoutingWorker::Job &job)
+  {
+    uint64_t hash = 14695981039346656037ULL; // FNV-1a
+
+    const NdnGlobalRouterGraphSnapshot &graph = job.m_graph;
+    Add (hash, job.m_allPossibleRoutes);
+    Add (hash, job.m_loopFreeOnly);
+    Add (hash, job.m_detours);
+    Add (hash, graph.GetNVertices ());
+    for (uint32_t vertex = 0; vertex < graph.GetNVertices (); vertex++)
+      {
+        Add (hash, graph.m_vertices[vertex] != 0);
+        Add (hash, graph.m_offsets[vertex + 1] - graph.m_offsets[vertex]);
+        for (NdnGlobalRouterGraphSnapshot::edge_iterator edge = graph.BeginEdges (vertex);
+             edge != graph.EndEdges (vertex);
+             edge++)
+          {
+            Add (hash, edge->m_target);
+            Add (hash, edge->m_face);
+            Add (hash, edge->m_face != NdnGlobalRouterGraphSnapshot::NO_FACE ? graph.m_faceIds[edge->m_face] : 0);
+            Add (hash, edge->m_metric);
+            Add (hash, edge->m_delay);
+          }
+      }
+
+    Add (hash, job.m_sources.size ());
+    BOOST_FOREACH (uint32_t source, job.m_sources)
+      {
+        Add (hash, source);
+      }
+
+    Add (hash, job.m_origins.size ());
+    BOOST_FOREACH (uint32_t origin, job.m_origins)
+      {
+        Add (hash, origin);
+
+        std::ostringstream os;
+        BOOST_FOREACH (const Ptr<const Name> &prefix, graph.m_vertices[origin]->GetLocalPrefixes ())
+          {
+            os << *prefix << "\n";
+          }
+        const std::string &prefixes = os.str ();
+        for (std::string::const_iterator c = prefixes.begin (); c != prefixes.end (); c++)
+          {
+            Add (hash, *c);
+          }
+      }
+
+    return hash;
+  }
+
+  static bool
+  Load (const std::string &fileName, uint64_t hash, GlobalRoutingWorker::Job &job)
+  {
+    std::ifstream is (fileName.c_str (), std::ios::in | std::ios::binary);
+    if (!is.good ())
+      return false;
+
+    uint32_t magic = 0, version = 0, nSources = 0;
+    uint64_t fileHash = 0;
+    if (!Read (is, magic) || magic != MAGIC ||
+        !Read (is, version) || version != VERSION ||
+        !Read (is, fileHash) || fileHash != hash ||
+        !Read (is, nSources) || nSources != job.m_sources.size ())
+      return false;
+
+    std::vector<GlobalRoutingWorker::RouteList> routes (nSources);
+    for (uint32_t sourceNo = 0; sourceNo < nSources; sourceNo++)
+      {
+        uint32_t nRoutes = 0;
+        if (!Read (is, nRoutes))
+          return false;
+
+        routes[sourceNo].resize (nRoutes);
+        for (uint32_t i = 0; i < nRoutes; i++)
+          {
+            GlobalRoutingWorker::Route &route = routes[sourceNo][i];
+            if (!Read (is, route.m_origin) || !Read (is, route.m_face) ||
+                !Read (is, route.m_metric) || !Read (is, route.m_delay))
+              return false;
+
+            if (route.m_origin >= job.m_graph.GetNVertices () || job.m_graph.m_vertices[route.m_origin] == 0 ||
+                route.m_face >= job.m_graph.m_faces.size ())
+              return false; // corrupted file
+          }
+      }
+
+    job.m_routes.swap (routes);
+    return true;
+  }
+
+  static void
+  Save (const std::string &fileName, uint64_t hash, const GlobalRoutingWorker::Job &job)
+  {
+    std::ofstream os (fileName.c_str (), std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!os.good ())
+      {
+        NS_LOG_ERROR ("Cannot write routes to " << fileName);
+        return;
+      }
+
+    Write (os, MAGIC);
+    Write (os, VERSION);
+    Write (os, hash);
+    Write (os, static_cast<uint32_t> (job.m_routes.size ()));
+    BOOST_FOREACH (const GlobalRoutingWorker::RouteList &routes, job.m_routes)
+      {
+        Write (os, static_cast<uint32_t> (routes.size ()));
+        BOOST_FOREACH (const GlobalRoutingWorker::Route &route, routes)
+          {
+            Write (os, route.m_origin);
+            Write (os, route.m_face);
+            Write (os, route.m_metric);
+            Write (os, route.m_delay);
+          }
+      }
+  }
+
+private:
+  static const uint32_t MAGIC = 0x4e44524f; // "NDRO"
+  static const uint32_t VERSION = 2;
+
+  template<class T>
+  static void
+  Add (uint64_t &hash, const T &value)
+  {
+    const unsigned char *data = reinterpret_cast<const unsigned char*> (&value);
+    for (size_t i = 0; i < sizeof (T); i++)
+      {
+        hash ^= data[i];
+        hash *= 1099511628211ULL;
+      }
+  }
+
+  static void
+  Add (uint64_t &hash, bool value)
+  {
+    Add<uint8_t> (hash, value ? 1 : 0);
+  }
+
+  static void
+  Add (uint64_t &hash, size_t value)
+  {
+    Add<uint64_t> (hash, value);
+  }
+
+  template<class T>
+  static bool
+  Read (std::istream &is, T &value)
+  {
+    is.read (reinterpret_cast<char*> (&value), sizeof (T));
+    return is.good ();
+  }
+
+  template<class T>
+  static void
+  Write (std::ostream &os, T value)
+  {
+    os.write (reinterpret_cast<const char*> (&value), sizeof (T));
+  }
+};
+/// @endcond
+
 void
 GlobalRoutingHelper::Install (Ptr<Node> node)
 {
@@ -230,20 +661,51 @@ GlobalRoutingHelper::AddOriginsForAll ()
 void
 GlobalRoutingHelper::CalculateRoutes ()
 {
-  /**
-   * Implementation of route calculation is heavily based on Boost Graph Library
-   * See http://www.boost.org/doc/libs/1_49_0/libs/graph/doc/table_of_contents.html for more details
-   */
+  m_allPossibleRoutes = false;
+  CalculateRoutesForSources (GetAllRouters (), false, true);
+}
+
+void
+GlobalRoutingHelper::CalculateAllPossibleRoutes ()
+{
+  m_allPossibleRoutes = true;
+  CalculateRoutesForSources (GetAllRouters (), true, true);
+}
 
-  BOOST_CONCEPT_ASSERT(( VertexListGraphConcept< NdnGlobalRouterGraph > ));
-  BOOST_CONCEPT_ASSERT(( IncidenceGraphConcept< NdnGlobalRouterGraph > ));
+void
+GlobalRoutingHelper::SetNumberOfThreads (uint32_t threads)
+{
+  m_numberOfThreads = std::max<uint32_t> (threads, 1);
+}
 
-  NdnGlobalRouterGraph graph;
-  typedef graph_traits < NdnGlobalRouterGraph >::vertex_descriptor vertex_descriptor;
+void
+GlobalRoutingHelper::SetMaxNextHops (uint32_t maxNextHops)
+{
+  m_maxNextHops = maxNextHops;
+}
+
+void
+GlobalRoutingHelper::SetLoopFreeNextHopsOnly (bool loopFreeOnly)
+{
+  m_loopFreeNextHopsOnly = loopFreeOnly;
+}
+
+void
+GlobalRoutingHelper::SetPrefixAggregation (bool aggregate)
+{
+  m_prefixAggregation = aggregate;
+}
 
-  // For now we doing Dijkstra for every node.  Can be replaced with Bellman-Ford or Floyd-Warshall.
-  // Other algorithms should be faster, but they need additional EdgeListGraph concept provided by the graph, which
-  // is not obviously how implement in an efficient manner
+void
+GlobalRoutingHelper::SetRouteCacheFile (const std::string &fileName)
+{
+  m_routeCacheFile = fileName;
+}
+
+std::vector< Ptr<GlobalRouter> >
+GlobalRoutingHelper::GetAllRouters ()
+{
+  std::vector< Ptr<GlobalRouter> > routers;
   for (NodeList::Iterator node = NodeList::Begin (); node != NodeList::End (); node++)
     {
       Ptr<GlobalRouter> source = (*node)->GetObject<GlobalRouter> ();
@@ -252,197 +714,435 @@ GlobalRoutingHelper::CalculateRoutes ()
 	  NS_LOG_DEBUG ("Node " << (*node)->GetId () << " does not export GlobalRouter interface");
 	  continue;
 	}
-
-      DistancesMap    distances;
-
-      dijkstra_shortest_paths (graph, source,
-			       // predecessor_map (boost::ref(predecessors))
-			       // .
-			       distance_map (boost::ref(distances))
-			       .
-			       distance_inf (WeightInf)
-			       .
-			       distance_zero (WeightZero)
-			       .
-			       distance_compare (boost::WeightCompare ())
-			       .
-			       distance_combine (boost::WeightCombine ())
-			       );
-
-      // NS_LOG_DEBUG (predecessors.size () << ", " << distances.size ());
-
-      Ptr<Fib>  fib  = source->GetObject<Fib> ();
-      fib->InvalidateAll ();
-      NS_ASSERT (fib != 0);
-
-      NS_LOG_DEBUG ("Reachability from Node: " << source->GetObject<Node> ()->GetId ());
-      for (DistancesMap::iterator i = distances.begin ();
-	   i != distances.end ();
-	   i++)
-	{
-	  if (i->first == source)
-	    continue;
-	  else
-	    {
-	      // cout << "  Node " << i->first->GetObject<Node> ()->GetId ();
-	      if (i->second.get<0> () == 0)
-		{
-		  // cout << " is unreachable" << endl;
-		}
-	      else
-		{
-                  BOOST_FOREACH (const Ptr<const Name> &prefix, i->first->GetLocalPrefixes ())
-                    {
-                      NS_LOG_DEBUG (" prefix " << prefix << " reachable via face " << *i->second.get<0> ()
-                                    << " with distance " << i->second.get<1> ()
-                                    << " with delay " << i->second.get<2> ());
-
-                      Ptr<fib::Entry> entry = fib->Add (prefix, i->second.get<0> (), i->second.get<1> ());
-                      entry->SetRealDelayToProducer (i->second.get<0> (), Seconds (i->second.get<2> ()));
-
-                      Ptr<Limits> faceLimits = i->second.get<0> ()->GetObject<Limits> ();
-
-                      Ptr<Limits> fibLimits = entry->GetObject<Limits> ();
-                      if (fibLimits != 0)
-                        {
-                          // if it was created by the forwarding strategy via DidAddFibEntry event
-                          fibLimits->SetLimits (faceLimits->GetMaxRate (), 2 * i->second.get<2> () /*exact RTT*/);
-                          NS_LOG_DEBUG ("Set limit for prefix " << *prefix << " " << faceLimits->GetMaxRate () << " / " <<
-                                        2*i->second.get<2> () << "s (" << faceLimits->GetMaxRate () * 2 * i->second.get<2> () << ")");
-                        }
-                    }
-		}
-	    }
-	}
+      routers.push_back (source);
     }
+  return routers;
 }
 
 void
-GlobalRoutingHelper::CalculateAllPossibleRoutes ()
+GlobalRoutingHelper::CalculateRoutesForSources (const std::vector< Ptr<GlobalRouter> > &sources, bool allPossibleRoutes,
+                                                bool useCache/* = false*/)
 {
   /**
-   * Implementation of route calculation is heavily based on Boost Graph Library
-   * See http://www.boost.org/doc/libs/1_49_0/libs/graph/doc/table_of_contents.html for more details
+   * Shortest paths are calculated on a read-only snapshot of the graph, which contains only plain data.
+   * So, paths for different sources can be calculated in parallel.  All ns-3 objects (Ptr<>s, FIBs)
+   * are accessed only from the main thread.
    */
 
-  BOOST_CONCEPT_ASSERT(( VertexListGraphConcept< NdnGlobalRouterGraph > ));
-  BOOST_CONCEPT_ASSERT(( IncidenceGraphConcept< NdnGlobalRouterGraph > ));
+  NdnGlobalRouterGraph graph;
+  NdnGlobalRouterGraphSnapshot snapshot (graph);
+
+  // detours are not loop-free and have the highest metrics, so they are not useful if next hops are restricted
+  GlobalRoutingWorker::Job job (snapshot, allPossibleRoutes, m_loopFreeNextHopsOnly,
+                                !m_loopFreeNextHopsOnly && m_maxNextHops == 0);
+  BOOST_FOREACH (const Ptr<GlobalRouter> &source, sources)
+    {
+      job.m_sources.push_back (snapshot.GetIndex (source));
+    }
+  for (uint32_t vertex = 0; vertex < snapshot.m_vertices.size (); vertex++)
+    {
+      if (snapshot.m_vertices[vertex] != 0 && !snapshot.m_vertices[vertex]->GetLocalPrefixes ().empty ())
+        job.m_origins.push_back (vertex);
+    }
+  job.m_routes.resize (sources.size ());
+
+  if (useCache && !m_routeCacheFile.empty ())
+    {
+      uint64_t hash = GlobalRoutingCache::Hash (job);
+      if (GlobalRoutingCache::Load (m_routeCacheFile, hash, job))
+        {
+          NS_LOG_INFO ("Routes are loaded from " << m_routeCacheFile);
+        }
+      else
+        {
+          NS_LOG_INFO ("No routes for the topology in " << m_routeCacheFile << ", calculating");
+          GlobalRoutingWorker::RunAll (job, m_numberOfThreads);
+          GlobalRoutingCache::Save (m_routeCacheFile, hash, job);
+        }
+    }
+  else
+    {
+      GlobalRoutingWorker::RunAll (job, m_numberOfThreads);
+    }
+
+  // FIBs are updated in the order of nodes in NodeList, independent of the number of threads
+  for (uint32_t i = 0; i < sources.size (); i++)
+    {
+      NS_LOG_DEBUG ("Reachability from Node: " << sources[i]->GetObject<Node> ()->GetId ());
+
+      Routes routes;
+      BOOST_FOREACH (const GlobalRoutingWorker::Route &route, job.m_routes[i])
+        {
+          BOOST_FOREACH (const Ptr<const Name> &prefix, snapshot.m_vertices[route.m_origin]->GetLocalPrefixes ())
+            {
+              NS_LOG_DEBUG (" prefix " << *prefix << " reachable via face " << *snapshot.m_faces[route.m_face]
+                            << " with distance " << route.m_metric
+                            << " with delay " << route.m_delay);
+
+              AddRoute (routes, prefix, snapshot.m_faces[route.m_face], route.m_metric, route.m_delay);
+            }
+        }
+      GlobalRoutingWorker::RouteList ().swap (job.m_routes[i]); // release memory
+
+      if (m_maxNextHops > 0)
+        LimitNextHops (routes, m_maxNextHops);
+
+      if (m_prefixAggregation)
+        AggregateRoutes (routes);
+
+      ApplyRoutes (sources[i], routes);
+    }
+}
+
+void
+GlobalRoutingHelper::UpdateLinkMetric (Ptr<Node> node1, Ptr<Node> node2, uint16_t metric)
+{
+  Ptr<GlobalRouter> gr1 = node1->GetObject<GlobalRouter> ();
+  Ptr<GlobalRouter> gr2 = node2->GetObject<GlobalRouter> ();
+  NS_ASSERT_MSG (gr1 != 0 && gr2 != 0, "GlobalRouter is not installed on the nodes");
+
+  Ptr<Face> face1 = FindFace (gr1, gr2);
+  Ptr<Face> face2 = FindFace (gr2, gr1);
+  NS_ASSERT_MSG (face1 != 0 && face2 != 0, "Nodes are not connected with a point-to-point link");
+
+  uint64_t minMetric1 = std::min (face1->GetMetric (), metric);
+  uint64_t minMetric2 = std::min (face2->GetMetric (), metric);
 
   NdnGlobalRouterGraph graph;
-  typedef graph_traits < NdnGlobalRouterGraph >::vertex_descriptor vertex_descriptor;
+  NdnGlobalRouterGraphSnapshot snapshot (graph);
 
-  // For now we doing Dijkstra for every node.  Can be replaced with Bellman-Ford or Floyd-Warshall.
-  // Other algorithms should be faster, but they need additional EdgeListGraph concept provided by the graph, which
-  // is not obviously how implement in an efficient manner
-  for (NodeList::Iterator node = NodeList::Begin (); node != NodeList::End (); node++)
+  // Distances from all nodes to both ends of the link, without using the link itself
+  NdnGlobalRouterGraphSnapshot reversed (snapshot, snapshot.GetFaceIndex (face1), snapshot.GetFaceIndex (face2));
+  NdnGlobalRouterDijkstra toNode1 (reversed);
+  NdnGlobalRouterDijkstra toNode2 (reversed);
+  toNode1.Run (reversed.GetIndex (gr1));
+  toNode2.Run (reversed.GetIndex (gr2));
+
+  face1->SetMetric (metric);
+  face2->SetMetric (metric);
+
+  if (m_allPossibleRoutes)
     {
-      Ptr<GlobalRouter> source = (*node)->GetObject<GlobalRouter> ();
-      if (source == 0)
-	{
-	  NS_LOG_DEBUG ("Node " << (*node)->GetId () << " does not export GlobalRouter interface");
-	  continue;
-	}
+      // routes via each face depend on distances from all neighbors (and on detours around the node),
+      // so all nodes recalculate routes the same way as CalculateAllPossibleRoutes does
+      CalculateRoutesForSources (GetAllRouters (), true);
+      return;
+    }
 
-      Ptr<Fib>  fib  = source->GetObject<Fib> ();
-      fib->InvalidateAll ();
-      NS_ASSERT (fib != 0);
+  std::vector< Ptr<GlobalRouter> > affectedSources;
+  BOOST_FOREACH (const Ptr<GlobalRouter> &source, GetAllRouters ())
+    {
+      uint32_t index = reversed.GetIndex (source);
+      bool reaches1 = toNode1.IsReachable (index);
+      bool reaches2 = toNode2.IsReachable (index);
+      uint64_t distanceTo1 = toNode1.GetDistance (index).m_metric;
+      uint64_t distanceTo2 = toNode2.GetDistance (index).m_metric;
+
+      // Shortest paths from the source can go over the link (before or after the change) only if
+      // one end of the link is not farther than the other end plus the link metric
+      bool affected =
+        (reaches1 && (!reaches2 || distanceTo1 + minMetric1 <= distanceTo2)) ||
+        (reaches2 && (!reaches1 || distanceTo2 + minMetric2 <= distanceTo1));
+
+      if (affected)
+        {
+          NS_LOG_DEBUG ("Node " << source->GetObject<Node> ()->GetId () << " is affected by the link change");
+          affectedSources.push_back (source);
+        }
+    }
+
+  CalculateRoutesForSources (affectedSources, false);
+}
+
+Ptr<Face>
+GlobalRoutingHelper::FindFace (Ptr<GlobalRouter> from, Ptr<GlobalRouter> to)
+{
+  BOOST_FOREACH (const GlobalRouter::Incidency &edge, from->GetIncidencies ())
+    {
+      if (edge.get<2> () == to && edge.get<1> () != 0)
+        return edge.get<1> ();
+    }
+  return 0;
+}
+
+bool
+GlobalRoutingHelper::PrefixCompare::operator () (const Name *a, const Name *b) const
+{
+  return *a < *b;
+}
+
+void
+GlobalRoutingHelper::AddRoute (Routes &routes, Ptr<const Name> prefix, Ptr<Face> face, uint32_t metric, double delay)
+{
+  Routes::iterator route = routes.find (PeekPointer (prefix));
+  if (route == routes.end ())
+    {
+      route = routes.insert (std::make_pair (PeekPointer (prefix), std::make_pair (prefix, NextHops ()))).first;
+    }
+
+  NextHops::iterator nextHop = route->second.second.find (face);
+  if (nextHop == route->second.second.end ())
+    {
+      route->second.second.insert (std::make_pair (face, NextHop (metric, delay)));
+    }
+  else if (metric < nextHop->second.m_metric)
+    {
+      // the same as FIB does: don't update metric to higher value
+      nextHop->second = NextHop (metric, delay);
+    }
+}
+
+void
+GlobalRoutingHelper::LimitNextHops (Routes &routes, uint32_t maxNextHops)
+{
+  for (Routes::iterator route = routes.begin (); route != routes.end (); route++)
+    {
+      NextHops &nextHops = route->second.second;
+      if (nextHops.size () <= maxNextHops)
+        continue;
+
+      // rank by metric, ties are resolved by face ID
+      std::vector< std::pair< std::pair<uint32_t, uint32_t>, Ptr<Face> > > ranked;
+      for (NextHops::iterator nextHop = nextHops.begin (); nextHop != nextHops.end (); nextHop++)
+        {
+          ranked.push_back (std::make_pair (std::make_pair (nextHop->second.m_metric, nextHop->first->GetId ()),
+                                            nextHop->first));
+        }
+      std::sort (ranked.begin (), ranked.end ());
+
+      for (uint32_t i = maxNextHops; i < ranked.size (); i++)
+        {
+          NS_LOG_DEBUG ("Dropping next hop " << *ranked[i].second << " for prefix " << *route->second.first
+                        << " with distance " << ranked[i].first.first);
+          nextHops.erase (ranked[i].second);
+        }
+    }
+}
+
+bool
+GlobalRoutingHelper::IsSameNextHops (const NextHops &a, const NextHops &b)
+{
+  if (a.size () != b.size ())
+    return false;
+
+  for (NextHops::const_iterator i = a.begin (), j = b.begin (); i != a.end (); i++, j++)
+    {
+      if (i->first != j->first ||
+          i->second.m_metric != j->second.m_metric ||
+          i->second.m_delay != j->second.m_delay)
+        return false;
+    }
+  return true;
+}
+
+static bool
+IsPrefixOf (const Name &prefix, const Name &name)
+{
+  return prefix.size () <= name.size () &&
+    std::equal (prefix.GetComponents ().begin (), prefix.GetComponents ().end (), name.GetComponents ().begin ());
+}
 
-      NS_LOG_DEBUG ("===========");
-      NS_LOG_DEBUG ("Reachability from Node: " << source->GetObject<Node> ()->GetId () << " (" << Names::FindName (source->GetObject<Node> ()) << ")");
+void
+GlobalRoutingHelper::AggregateRoutes (Routes &routes)
+{
+  if (routes.empty ())
+    return;
 
-      Ptr<L3Protocol> l3 = source->GetObject<L3Protocol> ();
-      NS_ASSERT (l3 != 0);
+  // 1. Merge sibling prefixes with identical next hops into their parent, bottom-up, if neither parent nor
+  //    any of its less specific prefixes is routed.  Parent is never the root prefix, so aggregated routes
+  //    never become default routes
+  size_t maxLength = 0;
+  for (Routes::const_iterator route = routes.begin (); route != routes.end (); route++)
+    {
+      maxLength = std::max (maxLength, route->first->size ());
+    }
 
-      // remember interface statuses
-      std::vector<uint16_t> originalMetric (l3->GetNFaces ());
-      for (uint32_t faceId = 0; faceId < l3->GetNFaces (); faceId++)
+  for (size_t length = maxLength; length > 1; length--)
+    {
+      std::map< Name, std::vector<Routes::iterator> > siblings;
+      for (Routes::iterator route = routes.begin (); route != routes.end (); route++)
         {
-          originalMetric[faceId] = l3->GetFace (faceId)->GetMetric ();
-          l3->GetFace (faceId)->SetMetric (std::numeric_limits<uint16_t>::max ()-1); // value std::numeric_limits<uint16_t>::max () MUST NOT be used (reserved)
+          if (route->first->size () == length)
+            siblings[route->first->cut (1)].push_back (route);
         }
 
-      for (uint32_t enabledFaceId = 0; enabledFaceId < l3->GetNFaces (); enabledFaceId++)
+      for (std::map< Name, std::vector<Routes::iterator> >::iterator group = siblings.begin ();
+           group != siblings.end ();
+           group++)
         {
-          if (DynamicCast<ndn::NetDeviceFace> (l3->GetFace (enabledFaceId)) == 0)
+          const std::vector<Routes::iterator> &children = group->second;
+          if (children.size () < 2 || routes.find (&group->first) != routes.end ())
             continue;
 
-          // enabling only faceId
-          l3->GetFace (enabledFaceId)->SetMetric (originalMetric[enabledFaceId]);
+          bool same = true;
+          for (uint32_t i = 1; same && i < children.size (); i++)
+            {
+              same = IsSameNextHops (children[0]->second.second, children[i]->second.second);
+            }
+          if (!same)
+            continue;
 
-          DistancesMap    distances;
+          // names under the parent should not be diverted from an already routed less specific prefix
+          bool covered = false;
+          Name ancestor = group->first;
+          while (!covered && ancestor.size () > 0)
+            {
+              ancestor = ancestor.cut (1);
+              covered = routes.find (&ancestor) != routes.end ();
+            }
+          if (covered)
+            continue;
+
+          NS_LOG_DEBUG ("Aggregating " << children.size () << " prefixes into " << group->first);
+
+          Ptr<const Name> parent = Create<Name> (group->first);
+          NextHops nextHops = children[0]->second.second;
+          for (uint32_t i = 0; i < children.size (); i++)
+            {
+              routes.erase (children[i]);
+            }
+          routes.insert (std::make_pair (PeekPointer (parent), std::make_pair (parent, nextHops)));
+        }
+    }
 
-          NS_LOG_DEBUG ("-----------");
+  // 2. Remove prefixes that have the same next hops as their longest matching less specific prefix.
+  //    Routes are ordered so that all prefixes under a prefix immediately follow it
+  std::vector<Routes::iterator> ancestors;
+  for (Routes::iterator route = routes.begin (); route != routes.end (); )
+    {
+      while (!ancestors.empty () && !IsPrefixOf (*ancestors.back ()->first, *route->first))
+        ancestors.pop_back ();
 
-          dijkstra_shortest_paths (graph, source,
-                                   // predecessor_map (boost::ref(predecessors))
-                                   // .
-                                   distance_map (boost::ref(distances))
-                                   .
-                                   distance_inf (WeightInf)
-                                   .
-                                   distance_zero (WeightZero)
-                                   .
-                                   distance_compare (boost::WeightCompare ())
-                                   .
-                                   distance_combine (boost::WeightCombine ())
-                                   );
+      if (!ancestors.empty () && IsSameNextHops (ancestors.back ()->second.second, route->second.second))
+        {
+          NS_LOG_DEBUG ("Prefix " << *route->first << " is covered by " << *ancestors.back ()->first);
+          routes.erase (route++);
+          continue;
+        }
+
+      ancestors.push_back (route);
+      route++;
+    }
+}
 
-          // NS_LOG_DEBUG (predecessors.size () << ", " << distances.size ());
+void
+GlobalRoutingHelper::ApplyRoutes (Ptr<GlobalRouter> source, const Routes &routes)
+{
+  Ptr<Fib>  fib  = source->GetObject<Fib> ();
+  NS_ASSERT (fib != 0);
+
+  // invalidate next hops installed by the helper that are no longer present in the calculated routes
+  // (next hops added by applications or manually are never touched)
+  GlobalRouter::InstalledRoutes &installedRoutes = source->GetInstalledRoutes ();
+  for (GlobalRouter::InstalledRoutes::iterator installed = installedRoutes.begin ();
+       installed != installedRoutes.end ();
+       )
+    {
+      Ptr<fib::Entry> entry = fib->Find (installed->first);
+      if (entry == 0)
+        {
+          installedRoutes.erase (installed++);
+          continue;
+        }
 
-          for (DistancesMap::iterator i = distances.begin ();
-               i != distances.end ();
-               i++)
+      Routes::const_iterator route = routes.find (&installed->first);
+      if (route == routes.end () && m_prefixAggregation)
+        {
+          // with aggregation, invalid entry would shadow the aggregated (less specific) prefix,
+          // so the entry is removed if it has only next hops installed by the helper
+          bool onlyInstalled = true;
+          BOOST_FOREACH (const fib::FaceMetric &faceMetric, entry->m_faces)
             {
-              if (i->first == source)
-                continue;
-              else
+              if (installed->second.find (faceMetric.GetFace ()) == installed->second.end ())
                 {
-                  // cout << "  Node " << i->first->GetObject<Node> ()->GetId ();
-                  if (i->second.get<0> () == 0)
-                    {
-                      // cout << " is unreachable" << endl;
-                    }
-                  else
-                    {
-                      BOOST_FOREACH (const Ptr<const Name> &prefix, i->first->GetLocalPrefixes ())
-                        {
-                          NS_LOG_DEBUG (" prefix " << *prefix << " reachable via face " << *i->second.get<0> ()
-                                        << " with distance " << i->second.get<1> ()
-                                        << " with delay " << i->second.get<2> ());
-
-                          if (i->second.get<0> ()->GetMetric () == std::numeric_limits<uint16_t>::max ()-1)
-                            continue;
-
-                          Ptr<fib::Entry> entry = fib->Add (prefix, i->second.get<0> (), i->second.get<1> ());
-                          entry->SetRealDelayToProducer (i->second.get<0> (), Seconds (i->second.get<2> ()));
-
-                          Ptr<Limits> faceLimits = i->second.get<0> ()->GetObject<Limits> ();
-
-                          Ptr<Limits> fibLimits = entry->GetObject<Limits> ();
-                          if (fibLimits != 0)
-                            {
-                              // if it was created by the forwarding strategy via DidAddFibEntry event
-                              fibLimits->SetLimits (faceLimits->GetMaxRate (), 2 * i->second.get<2> () /*exact RTT*/);
-                              NS_LOG_DEBUG ("Set limit for prefix " << *prefix << " " << faceLimits->GetMaxRate () << " / " <<
-                                            2*i->second.get<2> () << "s (" << faceLimits->GetMaxRate () * 2 * i->second.get<2> () << ")");
-                            }
-                        }
-                    }
+                  onlyInstalled = false;
+                  break;
                 }
             }
 
-          // disabling the face again
-          l3->GetFace (enabledFaceId)->SetMetric (std::numeric_limits<uint16_t>::max ()-1);
+          if (onlyInstalled)
+            {
+              fib->Remove (Create<Name> (installed->first));
+              installedRoutes.erase (installed++);
+              continue;
+            }
         }
 
-      // recover original interface statuses
-      for (uint32_t faceId = 0; faceId < l3->GetNFaces (); faceId++)
+      BOOST_FOREACH (Ptr<Face> face, installed->second)
         {
-          l3->GetFace (faceId)->SetMetric (originalMetric[faceId]);
+          if (route != routes.end () &&
+              route->second.second.find (face) != route->second.second.end ())
+            continue;
+
+          fib::FaceMetricContainer::type::const_iterator record = entry->m_faces.find (face);
+          if (record != entry->m_faces.end () &&
+              record->GetStatus () != fib::FaceMetric::NDN_FIB_RED)
+            {
+              entry->Invalidate (face);
+            }
         }
+      installed++;
     }
-}
 
+  // invalidated next hops are still remembered, as they remain in FIB
+  for (Routes::const_iterator route = routes.begin (); route != routes.end (); route++)
+    {
+      std::set< Ptr<Face> > &faces = installedRoutes[*route->first];
+      for (NextHops::const_iterator nextHop = route->second.second.begin ();
+           nextHop != route->second.second.end ();
+           nextHop++)
+        {
+          faces.insert (nextHop->first);
+        }
+    }
+
+  // add new and update changed next hops
+  for (Routes::const_iterator route = routes.begin (); route != routes.end (); route++)
+    {
+      const Ptr<const Name> &prefix = route->second.first;
+      Ptr<fib::Entry> entry = fib->Find (*prefix);
+
+      for (NextHops::const_iterator nextHop = route->second.second.begin ();
+           nextHop != route->second.second.end ();
+           nextHop++)
+        {
+          Ptr<Face> face = nextHop->first;
+          uint32_t metric = nextHop->second.m_metric;
+          double delay = nextHop->second.m_delay;
+
+          if (entry != 0)
+            {
+              fib::FaceMetricContainer::type::const_iterator record = entry->m_faces.find (face);
+              if (record != entry->m_faces.end () &&
+                  record->GetStatus () != fib::FaceMetric::NDN_FIB_RED)
+                {
+                  if (record->GetRoutingCost () == static_cast<int32_t> (metric) &&
+                      record->GetRealDelay () == Seconds (delay))
+                    {
+                      continue; // nothing has changed
+                    }
+
+                  // otherwise Add will not increase metric of a valid next hop
+                  entry->Invalidate (face);
+                }
+            }
+
+          entry = fib->Add (prefix, face, metric);
+          entry->SetRealDelayToProducer (face, Seconds (delay));
+
+          Ptr<Limits> faceLimits = face->GetObject<Limits> ();
+
+          Ptr<Limits> fibLimits = entry->GetObject<Limits> ();
+          if (fibLimits != 0)
+            {
+              // if it was created by the forwarding strategy via DidAddFibEntry event
+              fibLimits->SetLimits (faceLimits->GetMaxRate (), 2 * delay /*exact RTT*/);
+              NS_LOG_DEBUG ("Set limit for prefix " << *prefix << " " << faceLimits->GetMaxRate () << " / " <<
+                            2*delay << "s (" << faceLimits->GetMaxRate () * 2 * delay << ")");
+            }
+        }
+    }
+}
 
 } // namespace ndn
 } // namespace ns3
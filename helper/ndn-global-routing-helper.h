@@ -23,6 +23,11 @@
 
 #include "ns3/ptr.h"
 
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
 namespace ns3 {
 
 class Node;
@@ -31,6 +36,10 @@ class Channel;
 
 namespace ndn {
 
+class Face;
+class Name;
+class GlobalRouter;
+
 /**
  * @ingroup ndn
  * @brief Helper for GlobalRouter interface
@@ -104,16 +113,181 @@ public:
   /**
    * @brief Calculate all possible next-hop independent alternative routes
    *
-   * Refer to the implementation for more details.
+   * For every face of every node, the best route via this face is installed, i.e., metric of the face plus
+   * shortest distance from the neighbor to the prefix origin.  If the neighbor's shortest path to the origin
+   * leads back through the node itself, the shortest path from the neighbor that avoids the node is used
+   * instead.  Such faces are not used if SetLoopFreeNextHopsOnly or SetMaxNextHops is set.
+   *
+   * Distances from all nodes are obtained from one shortest path tree towards each prefix origin (plus one
+   * more for each node that has faces of the latter kind), so calculation cost is proportional to the number
+   * of origins rather than to the total number of faces.
    *
-   * Note that this method is highly experimental and should be used with caution (very time consuming).
+   * @see SetLoopFreeNextHopsOnly, SetMaxNextHops
    */
   static void
   CalculateAllPossibleRoutes ();
 
+  /**
+   * @brief Change metric of the point-to-point link between two nodes and update routes
+   *
+   * Metric is changed on faces in both directions.  Routes are recalculated the same way as by the last call of
+   * CalculateRoutes or CalculateAllPossibleRoutes.  After CalculateRoutes, only nodes, whose shortest paths could
+   * go over the link before or after the change, recalculate routes.  After CalculateAllPossibleRoutes, all nodes
+   * recalculate routes.  In both cases, only FIB records that actually changed are updated.
+   *
+   * @param node1  Node on one side of the link
+   * @param node2  Node on the other side of the link
+   * @param metric New metric of the link
+   */
+  static void
+  UpdateLinkMetric (Ptr<Node> node1, Ptr<Node> node2, uint16_t metric);
+
+  /**
+   * @brief Set number of threads used to calculate routes (default is 1)
+   *
+   * Shortest paths for different nodes are calculated in parallel using a read-only snapshot of the graph.
+   * FIBs are updated afterwards on the main thread in the order of nodes in NodeList, so results do not
+   * depend on the number of threads.
+   *
+   * If ns-3 is built without threading support, routes are always calculated on the main thread.
+   */
+  static void
+  SetNumberOfThreads (uint32_t threads);
+
+  /**
+   * @brief Set maximum number of next hops installed in FIB for each prefix (default is 0, i.e., no limit)
+   *
+   * If more next hops are available, only next hops with the lowest metrics are installed (ties are
+   * resolved by face ID)
+   */
+  static void
+  SetMaxNextHops (uint32_t maxNextHops);
+
+  /**
+   * @brief Install only loop-free next hops in CalculateAllPossibleRoutes (default is false)
+   *
+   * If enabled, a face is used only if the neighbor is strictly closer to the prefix origin than the node
+   * itself, so Interests forwarded over any combination of installed next hops never loop
+   */
+  static void
+  SetLoopFreeNextHopsOnly (bool loopFreeOnly);
+
+  /**
+   * @brief Set file to cache calculated routes between simulation runs (default is empty, i.e., no caching)
+   *
+   * CalculateRoutes and CalculateAllPossibleRoutes store calculated routes in the file, together with the hash of
+   * the topology (routers, links, face metrics and delays, prefix origins, and routing options).  If the hash of
+   * the current topology matches the hash in the file, routes are loaded from the file instead of being calculated.
+   * The file is written in the host byte order.
+   */
+  static void
+  SetRouteCacheFile (const std::string &fileName);
+
+  /**
+   * @brief Enable aggregation of routed prefixes before they are installed in FIBs (default is false)
+   *
+   * On each node, prefixes that have exactly the same next hops (faces, metrics, and delays) as their longest
+   * matching less specific prefix are not installed.  Sibling prefixes with identical next hops are replaced with
+   * their common parent (never with the root prefix), unless the parent itself is routed.  Longest prefix match
+   * for any name under the originated prefixes yields the same next hops as without aggregation; only names
+   * under the parent that are not originated by anybody become routable.
+   *
+   * FIB entries installed by the helper that are no longer present after aggregation are removed from FIB (instead
+   * of being invalidated), unless they also have next hops that were added otherwise (e.g., by applications).
+   */
+  static void
+  SetPrefixAggregation (bool aggregate);
+
 private:
   void
   Install (Ptr<Channel> channel);
+
+  /// @cond include_hidden
+  struct NextHop
+  {
+    NextHop (uint32_t metric, double delay)
+      : m_metric (metric)
+      , m_delay (delay)
+    {
+    }
+
+    uint32_t m_metric;
+    double m_delay;
+  };
+
+  struct PrefixCompare
+  {
+    bool
+    operator () (const Name *a, const Name *b) const;
+  };
+
+  typedef std::map< Ptr<Face>, NextHop > NextHops;
+  typedef std::map< const Name*, std::pair< Ptr<const Name>, NextHops >, PrefixCompare > Routes;
+  /// @endcond
+
+  /**
+   * @brief Find face of point-to-point link from one router to another (0 if there is no such link)
+   */
+  static Ptr<Face>
+  FindFace (Ptr<GlobalRouter> from, Ptr<GlobalRouter> to);
+
+  /**
+   * @brief Add route to the set of calculated routes (only the best metric is kept for each prefix-face pair)
+   */
+  static void
+  AddRoute (Routes &routes, Ptr<const Name> prefix, Ptr<Face> face, uint32_t metric, double delay);
+
+  /**
+   * @brief Get GlobalRouter interfaces of all nodes (in the order of NodeList)
+   */
+  static std::vector< Ptr<GlobalRouter> >
+  GetAllRouters ();
+
+  /**
+   * @brief Calculate routes from the sources to all prefix origins and update FIBs of the sources
+   * @param sources           nodes for which routes should be calculated
+   * @param allPossibleRoutes if true, calculate best route via each of the faces (see CalculateAllPossibleRoutes)
+   * @param useCache          if true, use route cache file (if set)
+   */
+  static void
+  CalculateRoutesForSources (const std::vector< Ptr<GlobalRouter> > &sources, bool allPossibleRoutes,
+                             bool useCache = false);
+
+  /**
+   * @brief Bring FIB of the source node in sync with calculated routes
+   *
+   * The resulting FIB is the same as after invalidating all next hops previously installed by the helper and
+   * adding all calculated routes, but only next hops that have changed are touched.  Next hops that were not
+   * installed by the helper (e.g., added by applications) are never changed.
+   */
+  static void
+  ApplyRoutes (Ptr<GlobalRouter> source, const Routes &routes);
+
+  /**
+   * @brief Keep only maxNextHops next hops with the lowest metrics for each prefix
+   */
+  static void
+  LimitNextHops (Routes &routes, uint32_t maxNextHops);
+
+  /**
+   * @brief Merge sibling prefixes and remove redundant more specific prefixes (see SetPrefixAggregation)
+   */
+  static void
+  AggregateRoutes (Routes &routes);
+
+  /**
+   * @brief Check if next hops have the same faces, metrics, and delays
+   */
+  static bool
+  IsSameNextHops (const NextHops &a, const NextHops &b);
+
+private:
+  static uint32_t m_numberOfThreads;
+  static uint32_t m_maxNextHops;
+  static bool m_loopFreeNextHopsOnly;
+  static std::string m_routeCacheFile;
+  static bool m_prefixAggregation;
+  static bool m_allPossibleRoutes; ///< @brief whether CalculateAllPossibleRoutes (not CalculateRoutes) was called last
 };
 
 } // namespace ndn
@@ -117,6 +117,28 @@ StackHelper::SetForwardingStrategy (const std::string &strategy,
       m_strategyFactory.Set (attr4, StringValue (value4));
 }
 
+void
+StackHelper::AddStrategyChoice (const std::string &prefix,
+                                const std::string &strategy,
+                                const std::string &attr1, const std::string &value1,
+                                const std::string &attr2, const std::string &value2,
+                                const std::string &attr3, const std::string &value3,
+                                const std::string &attr4, const std::string &value4)
+{
+  ObjectFactory factory;
+  factory.SetTypeId (strategy);
+  if (attr1 != "")
+      factory.Set (attr1, StringValue (value1));
+  if (attr2 != "")
+      factory.Set (attr2, StringValue (value2));
+  if (attr3 != "")
+      factory.Set (attr3, StringValue (value3));
+  if (attr4 != "")
+      factory.Set (attr4, StringValue (value4));
+
+  m_strategyChoice.push_back (std::make_pair (prefix, factory));
+}
+
 void
 StackHelper::SetContentStore (const std::string &contentStore,
                               const std::string &attr1, const std::string &value1,
@@ -253,11 +275,20 @@ StackHelper::Install (Ptr<Node> node) const
   ndn->AggregateObject (m_pitFactory.Create<Pit> ());
 
   // Create and aggregate forwarding strategy
-  ndn->AggregateObject (m_strategyFactory.Create<ForwardingStrategy> ());
+  Ptr<ForwardingStrategy> strategy = m_strategyFactory.Create<ForwardingStrategy> ();
+  ndn->AggregateObject (strategy);
 
   // Create and aggregate content store
   ndn->AggregateObject (m_contentStoreFactory.Create<ContentStore> ());
 
+  // Create namespace-specific forwarding strategies (before any face or route is added)
+  for (std::list< std::pair<std::string, ObjectFactory> >::const_iterator choice = m_strategyChoice.begin ();
+       choice != m_strategyChoice.end ();
+       choice++)
+    {
+      strategy->SetStrategyChoice (Name (choice->first), choice->second.Create<ForwardingStrategy> ());
+    }
+
   // Aggregate L3Protocol on node
   node->AggregateObject (ndn);
 
@@ -98,6 +98,26 @@ public:
                          const std::string &attr3 = "", const std::string &value3 = "",
                          const std::string &attr4 = "", const std::string &value4 = "");
 
+  /**
+   * @brief Use a different forwarding strategy for the namespace
+   * @param prefix                  namespace
+   * @param forwardingStrategyClass string containing name of the forwarding strategy class
+   *
+   * Interests and Data for names under `prefix` (longest prefix wins) will be processed by a separate
+   * instance of the strategy on each node, the rest of the traffic by the strategy set
+   * with SetForwardingStrategy.  For example, cheap BestRoute strategy can be used as a default,
+   * while only selected namespaces are handled by expensive adaptive strategies.
+   *
+   * @see ForwardingStrategy::SetStrategyChoice
+   */
+  void
+  AddStrategyChoice (const std::string &prefix,
+                     const std::string &forwardingStrategyClass,
+                     const std::string &attr1 = "", const std::string &value1 = "",
+                     const std::string &attr2 = "", const std::string &value2 = "",
+                     const std::string &attr3 = "", const std::string &value3 = "",
+                     const std::string &attr4 = "", const std::string &value4 = "");
+
   /**
    * @brief Set content store class and its attributes
    * @param contentStoreClass string, representing class of the content store
@@ -305,6 +325,8 @@ private:
   ObjectFactory m_pitFactory;
   ObjectFactory m_fibFactory;
 
+  std::list< std::pair<std::string, ObjectFactory> > m_strategyChoice;
+
   bool     m_limitsEnabled;
   Time     m_avgRtt;
   uint32_t m_avgContentObjectSize;
@@ -91,9 +91,15 @@ void
 FaceMetric::RecalculateNackRatio ()
 {
   double sample = m_nack>0 ? 1.0 * m_nack / (m_nack + m_data) : 0.0;
-  m_nackRatio = m_nackRatio * 0.875 + sample * 0.125;
-  if (m_nackRatio < 1e-6)
-    m_nackRatio = 1e-6;
+  double nackRatio = m_nackRatio * 0.875 + sample * 0.125;
+  if (nackRatio < 1e-6)
+    nackRatio = 1e-6;
+
+  if (nackRatio != m_nackRatio)
+    {
+      m_nackRatio = nackRatio;
+      NotifyChange ();
+    }
 
   m_nack = 0;
   m_data = 0;
@@ -109,11 +115,8 @@ Entry::UpdateFaceRtt (Ptr<Face> face, const Time &sample)
   NS_ASSERT_MSG (record != m_faces.get<i_face> ().end (),
                  "Update status can be performed only on existing faces of CcxnFibEntry");
 
-  m_faces.modify (record,
-                  ll::bind (&FaceMetric::UpdateRtt, ll::_1, sample));
-
-  // reordering random access index same way as by metric index
-  m_faces.get<i_nth> ().rearrange (m_faces.get<i_metric> ().begin ());
+  // RTT is not part of the ranking, no need to reorder faces
+  const_cast<FaceMetric&> (*record).UpdateRtt (sample);
 }
 
 void
@@ -125,11 +128,11 @@ Entry::UpdateStatus (Ptr<Face> face, FaceMetric::Status status)
   NS_ASSERT_MSG (record != m_faces.get<i_face> ().end (),
                  "Update status can be performed only on existing faces of CcxnFibEntry");
 
+  if (record->GetStatus () == status)
+    return;
+
   m_faces.modify (record,
                   ll::bind (&FaceMetric::SetStatus, ll::_1, status));
-
-  // reordering random access index same way as by metric index
-  m_faces.get<i_nth> ().rearrange (m_faces.get<i_metric> ().begin ());
 }
 
 void
@@ -139,11 +142,8 @@ Entry::UpdateFaceCounter (Ptr<Face> face, const bool nack)
   NS_ASSERT_MSG (record != m_faces.get<i_face> ().end (),
                  "Update status can be performed only on existing faces of CcxnFibEntry");
 
-  m_faces.modify (record,
-                  ll::bind (&FaceMetric::UpdateCounter, ll::_1, nack));
-
-  // reordering random access index same way as by metric index
-  m_faces.get<i_nth> ().rearrange (m_faces.get<i_metric> ().begin ());
+  // counters are not part of the ranking, no need to reorder faces
+  const_cast<FaceMetric&> (*record).UpdateCounter (nack);
 }
 
 void
@@ -163,15 +163,10 @@ Entry::AddOrUpdateRoutingMetric (Ptr<Face> face, int32_t metric)
     if (record->GetRoutingCost () > metric || record->GetStatus () == FaceMetric::NDN_FIB_RED)
       {
         m_faces.modify (record,
-                        ll::bind (&FaceMetric::SetRoutingCost, ll::_1, metric));
-
-        m_faces.modify (record,
-                        ll::bind (&FaceMetric::SetStatus, ll::_1, FaceMetric::NDN_FIB_YELLOW));
+                        (ll::bind (&FaceMetric::SetRoutingCost, ll::_1, metric),
+                         ll::bind (&FaceMetric::SetStatus, ll::_1, FaceMetric::NDN_FIB_YELLOW)));
       }
   }
-
-  // reordering random access index same way as by metric index
-  m_faces.get<i_nth> ().rearrange (m_faces.get<i_metric> ().begin ());
 }
 
 void
@@ -183,8 +178,8 @@ Entry::SetRealDelayToProducer (Ptr<Face> face, Time delay)
   FaceMetricByFace::type::iterator record = m_faces.get<i_face> ().find (face);
   if (record != m_faces.get<i_face> ().end ())
     {
-      m_faces.modify (record,
-                      ll::bind (&FaceMetric::SetRealDelay, ll::_1, delay));
+      // delay is not part of the ranking, no need to reorder faces
+      const_cast<FaceMetric&> (*record).SetRealDelay (delay);
     }
 }
 
@@ -192,18 +187,37 @@ Entry::SetRealDelayToProducer (Ptr<Face> face, Time delay)
 void
 Entry::Invalidate ()
 {
+  // faces are reordered on every modification, so collect them first
+  std::vector< Ptr<Face> > faces;
   for (FaceMetricByFace::type::iterator face = m_faces.begin ();
        face != m_faces.end ();
        face++)
     {
-      m_faces.modify (face,
-                      ll::bind (&FaceMetric::SetRoutingCost, ll::_1, std::numeric_limits<uint16_t>::max ()));
+      faces.push_back (face->GetFace ());
+    }
 
-      m_faces.modify (face,
-                      ll::bind (&FaceMetric::SetStatus, ll::_1, FaceMetric::NDN_FIB_RED));
+  for (std::vector< Ptr<Face> >::iterator face = faces.begin ();
+       face != faces.end ();
+       face++)
+    {
+      m_faces.modify (m_faces.get<i_face> ().find (*face),
+                      (ll::bind (&FaceMetric::SetRoutingCost, ll::_1, std::numeric_limits<uint16_t>::max ()),
+                       ll::bind (&FaceMetric::SetStatus, ll::_1, FaceMetric::NDN_FIB_RED)));
     }
 }
 
+void
+Entry::Invalidate (Ptr<Face> face)
+{
+  FaceMetricByFace::type::iterator record = m_faces.get<i_face> ().find (face);
+  if (record == m_faces.get<i_face> ().end ())
+    return;
+
+  m_faces.modify (record,
+                  (ll::bind (&FaceMetric::SetRoutingCost, ll::_1, std::numeric_limits<uint16_t>::max ()),
+                   ll::bind (&FaceMetric::SetStatus, ll::_1, FaceMetric::NDN_FIB_RED)));
+}
+
 const FaceMetric &
 Entry::FindBestCandidate (uint32_t skip/* = 0*/) const
 {
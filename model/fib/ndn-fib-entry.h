@@ -28,14 +28,9 @@
 #include "ns3/ndn-limits.h"
 #include "ns3/traced-value.h"
 
-#include <boost/multi_index_container.hpp>
-#include <boost/multi_index/tag.hpp>
-#include <boost/multi_index/ordered_index.hpp>
-#include <boost/multi_index/composite_key.hpp>
-#include <boost/multi_index/hashed_index.hpp>
-#include <boost/multi_index/random_access_index.hpp>
-#include <boost/multi_index/member.hpp>
-#include <boost/multi_index/mem_fun.hpp>
+#include <boost/iterator/indirect_iterator.hpp>
+#include <vector>
+#include <utility>
 
 namespace ns3 {
 namespace ndn {
@@ -44,9 +39,15 @@ class Name;
 typedef Name NameComponents;
 
 class Fib;
+class ForwardingStrategy;
+
+namespace pit { class Entry; }
 
 namespace fib {
 
+class FaceMetricFlatContainer;
+class FibImpl;
+
 /**
  * \ingroup ndn
  * \brief Structure holding various parameters associated with a (FibEntry, Face) tuple
@@ -78,6 +79,8 @@ public:
     , m_sRtt   (Seconds (0))
     , m_rttVar (Seconds (0))
     , m_realDelay (Seconds (0))
+    , m_container (0)
+    , m_indexPosition (0)
   { }
 
   /**
@@ -170,6 +173,25 @@ public:
   SetNackRate (double nackRatio)
   {
     m_nackRatio = nackRatio;
+    NotifyChange ();
+  }
+
+  /**
+   * @brief Get smoothed round-trip time (zero, if there were no RTT samples yet)
+   */
+  Time
+  GetSRtt () const
+  {
+    return m_sRtt;
+  }
+
+  /**
+   * @brief Get round-trip time variation
+   */
+  Time
+  GetRttVar () const
+  {
+    return m_rttVar;
   }
 
   /**
@@ -201,6 +223,14 @@ public:
 
 private:
   friend std::ostream& operator<< (std::ostream& os, const FaceMetric &metric);
+  friend class FaceMetricFlatContainer;
+  friend class FibImpl;
+
+  /**
+   * @brief Notify container that NACK ratio (part of the ranking) has changed, so the record is moved to its place in the rank order
+   */
+  inline void
+  NotifyChange ();
 
 private:
   Ptr<Face> m_face; ///< Face
@@ -221,6 +251,9 @@ private:
   Time m_rttVar;       ///< \brief round-trip time variation
 
   Time m_realDelay;    ///< \brief real propagation delay to the producer, calculated based on NS-3 p2p link delays
+
+  FaceMetricFlatContainer *m_container; ///< \brief container, to which record belongs (0 if none)
+  uint32_t m_indexPosition; ///< \brief position of the FIB entry in the per-face index of FIB (maintained by FibImpl)
 };
 
 /// @cond include_hidden
@@ -230,45 +263,233 @@ class i_nth {};
 /// @endcond
 
 
+/**
+ * \ingroup ndn
+ * \brief Flat container of next hops of FIB Entry
+ *
+ * FIB entries usually have just a few next hops, so instead of a multi-index container
+ * (with two trees rebalanced on every update), the metrics are referenced from a flat array that is
+ * kept in the rank order (m_status, m_routingCost, m_nackRatio).  Each FaceMetric is allocated separately,
+ * so references to FaceMetric (e.g., scheduled events and connected traces) remain valid while the order
+ * changes.  The best face is always the first element of the array.
+ *
+ * The container provides the same views as the old multi-index container did:
+ * - get<i_face> () for the lookup by face (linear search)
+ * - get<i_metric> () for iteration in the rank order
+ * - get<i_nth> () for random access to the nth-ranked face
+ *
+ * All views are the container itself, as the rank order is the only order maintained.
+ *
+ * Container maintains a version counter that changes whenever a record is added, removed, modified, or
+ * its NACK ratio changes.  It allows to cache data derived from the next hops (e.g., sampling tables of
+ * probabilistic forwarding strategies) and to detect when such data needs to be recalculated.
+ */
+class FaceMetricFlatContainer
+{
+public:
+  typedef std::vector<FaceMetric*> rank_container;
+  typedef boost::indirect_iterator<rank_container::const_iterator, const FaceMetric> iterator;
+  typedef iterator const_iterator;
+  typedef rank_container::size_type size_type;
+
+  /**
+   * @brief Type of the view for the tag (same container for all tags)
+   */
+  template<class Tag>
+  struct index
+  {
+    typedef FaceMetricFlatContainer type;
+  };
+
+  FaceMetricFlatContainer ()
+    : m_version (0)
+  {
+  }
+
+  ~FaceMetricFlatContainer ()
+  {
+    clear ();
+  }
+
+  template<class Tag>
+  inline FaceMetricFlatContainer &
+  get () { return *this; }
+
+  template<class Tag>
+  inline const FaceMetricFlatContainer &
+  get () const { return *this; }
+
+  inline const_iterator
+  begin () const { return m_rank.begin (); }
+
+  inline const_iterator
+  end () const { return m_rank.end (); }
+
+  inline size_type
+  size () const { return m_rank.size (); }
+
+  inline bool
+  empty () const { return m_rank.empty (); }
+
+  /**
+   * @brief Get version of the container (changes on every change of records)
+   */
+  inline uint32_t
+  GetVersion () const { return m_version; }
+
+  /**
+   * @brief Get nth-ranked face
+   */
+  inline const FaceMetric &
+  operator [] (size_type n) const { return *m_rank[n]; }
+
+  /**
+   * @brief Find record for the face (faces are unique within a node, pointer comparison is enough)
+   */
+  const_iterator
+  find (const Ptr<Face> &face) const
+  {
+    for (rank_container::const_iterator item = m_rank.begin (); item != m_rank.end (); item++)
+      {
+        if ((*item)->GetFace () == face)
+          return const_iterator (item);
+      }
+    return end ();
+  }
+
+  /**
+   * @brief Insert new record (if there is no record for the same face yet)
+   */
+  std::pair<const_iterator, bool>
+  insert (const FaceMetric &metric)
+  {
+    const_iterator item = find (metric.GetFace ());
+    if (item != end ())
+      return std::make_pair (item, false);
+
+    FaceMetric *record = new FaceMetric (metric);
+    record->m_container = this;
+    m_rank.push_back (record);
+    m_version ++;
+    return std::make_pair (Rerank (m_rank.size () - 1), true);
+  }
+
+  /**
+   * @brief Apply modifier to the record and restore the rank order
+   */
+  template<class Modifier>
+  bool
+  modify (const_iterator position, Modifier mod)
+  {
+    size_type pos = position.base () - m_rank.begin ();
+    mod (*m_rank[pos]);
+    Rerank (pos);
+    m_version ++;
+    return true;
+  }
+
+  void
+  erase (const Ptr<Face> &face)
+  {
+    const_iterator item = find (face);
+    if (item == end ())
+      return;
+
+    rank_container::iterator rankItem = m_rank.begin () + (item.base () - m_rank.begin ());
+    delete *rankItem;
+    m_rank.erase (rankItem);
+    m_version ++;
+  }
+
+  void
+  clear ()
+  {
+    for (rank_container::iterator item = m_rank.begin (); item != m_rank.end (); item++)
+      delete *item;
+    m_rank.clear ();
+    m_version ++;
+  }
+
+private:
+  friend class FaceMetric;
+
+  /**
+   * @brief Restore the rank order after ranking parameters of the record have been changed in place
+   */
+  void
+  RerankRecord (const FaceMetric *metric)
+  {
+    for (size_type pos = 0; pos < m_rank.size (); pos++)
+      {
+        if (m_rank[pos] == metric)
+          {
+            Rerank (pos);
+            m_version ++;
+            return;
+          }
+      }
+  }
+
+  FaceMetricFlatContainer (const FaceMetricFlatContainer &); ///< \brief Disabled copy constructor
+  FaceMetricFlatContainer& operator= (const FaceMetricFlatContainer &); ///< \brief Disabled copy operator
+
+  static inline bool
+  IsRankedBefore (const FaceMetric *a, const FaceMetric *b)
+  {
+    if (a->GetStatus () != b->GetStatus ())
+      return a->GetStatus () < b->GetStatus ();
+    if (a->GetRoutingCost () != b->GetRoutingCost ())
+      return a->GetRoutingCost () < b->GetRoutingCost ();
+    return a->GetNackRatio () < b->GetNackRatio ();
+  }
+
+  /**
+   * @brief Move element at position `pos` to its place in the rank order (equal elements keep insertion order)
+   */
+  const_iterator
+  Rerank (size_type pos)
+  {
+    FaceMetric *metric = m_rank[pos];
+    while (pos > 0 && IsRankedBefore (metric, m_rank[pos-1]))
+      {
+        m_rank[pos] = m_rank[pos-1];
+        pos --;
+      }
+    while (pos + 1 < m_rank.size () && !IsRankedBefore (metric, m_rank[pos+1]))
+      {
+        m_rank[pos] = m_rank[pos+1];
+        pos ++;
+      }
+    m_rank[pos] = metric;
+
+    return const_iterator (m_rank.begin () + pos);
+  }
+
+private:
+  rank_container m_rank;
+  uint32_t m_version;
+};
+
+inline void
+FaceMetric::NotifyChange ()
+{
+  if (m_container != 0)
+    m_container->RerankRecord (this);
+}
+
 /**
  * \ingroup ndn
  * \brief Typedef for indexed face container of Entry
  *
- * Currently, there are 2 indexes:
+ * Views:
  * - by face (used to find record and update metric)
  * - by metric (face ranking)
- * - random access index (for fast lookup on nth face). Order is
- *   maintained manually to be equal to the 'by metric' order
+ * - random access index (for fast lookup on nth face), the same as 'by metric' order
  */
 struct FaceMetricContainer
 {
   /// @cond include_hidden
-  typedef boost::multi_index::multi_index_container<
-    FaceMetric,
-    boost::multi_index::indexed_by<
-      // For fast access to elements using Face
-      boost::multi_index::ordered_unique<
-        boost::multi_index::tag<i_face>,
-        boost::multi_index::const_mem_fun<FaceMetric,Ptr<Face>,&FaceMetric::GetFace>
-      >,
-
-      // List of available faces ordered by (m_status, m_routingCost, m_nackRatio)
-      boost::multi_index::ordered_non_unique<
-        boost::multi_index::tag<i_metric>,
-        boost::multi_index::composite_key<
-          FaceMetric,
-          boost::multi_index::const_mem_fun<FaceMetric,FaceMetric::Status,&FaceMetric::GetStatus>,
-          boost::multi_index::const_mem_fun<FaceMetric,int32_t,&FaceMetric::GetRoutingCost>,
-          boost::multi_index::const_mem_fun<FaceMetric,double,&FaceMetric::GetNackRatio>
-        >
-      >,
-
-      // To optimize nth candidate selection (sacrifice a little bit space to gain speed)
-      boost::multi_index::random_access<
-        boost::multi_index::tag<i_nth>
-      >
-    >
-   > type;
+  typedef FaceMetricFlatContainer type;
   /// @endcond
 };
 
@@ -293,6 +514,8 @@ public:
   : m_fib (fib)
   , m_prefix (prefix)
   , m_needsProbing (false)
+  , m_strategy (0)
+  , m_pitEntries (0)
   {
   }
 
@@ -323,6 +546,14 @@ public:
   void
   Invalidate ();
 
+  /**
+   * @brief Invalidate single next hop
+   *
+   * Set routing metric of the face to max and status to RED
+   */
+  void
+  Invalidate (Ptr<Face> face);
+
   /**
    * @brief Update RTT averages for the face
    */
@@ -374,6 +605,10 @@ public:
   FaceMetricContainer::type m_faces; ///< \brief Indexed list of faces
 
   bool m_needsProbing;      ///< \brief flag indicating that probing should be performed
+
+  ForwardingStrategy *m_strategy; ///< \brief strategy responsible for the entry (cached by ForwardingStrategy::FindStrategy, 0 if not yet resolved)
+
+  pit::Entry *m_pitEntries; ///< \brief head of the list of PIT entries created for this FIB entry (maintained by Pit)
 };
 
 std::ostream& operator<< (std::ostream& os, const Entry &entry);
@@ -28,8 +28,13 @@
 #include "ns3/assert.h"
 #include "ns3/names.h"
 #include "ns3/log.h"
+#include "ns3/uinteger.h"
+
+#include <algorithm>
 
 #include <boost/ref.hpp>
+#include <boost/foreach.hpp>
+#include <boost/functional/hash.hpp>
 #include <boost/lambda/lambda.hpp>
 #include <boost/lambda/bind.hpp>
 namespace ll = boost::lambda;
@@ -49,11 +54,43 @@ FibImpl::GetTypeId (void)
     .SetParent<Fib> ()
     .SetGroupName ("Ndn")
     .AddConstructor<FibImpl> ()
+
+    .AddAttribute ("LpmCacheSize",
+                   "Number of records in the direct-mapped cache of longest prefix match results. If 0, cache is disabled",
+                   UintegerValue (64),
+                   MakeUintegerAccessor (&FibImpl::GetLpmCacheSize,
+                                         &FibImpl::SetLpmCacheSize),
+                   MakeUintegerChecker<uint32_t> ())
+
+    .AddAttribute ("LpmCacheComponents",
+                   "Maximum length (in components) of FIB prefixes, for which the LPM cache is used. "
+                   "The cache key is the first components of the name, up to the length of the longest FIB prefix, "
+                   "and the cache is bypassed while FIB contains prefixes longer than this value",
+                   UintegerValue (4),
+                   MakeUintegerAccessor (&FibImpl::GetLpmCacheComponents,
+                                         &FibImpl::SetLpmCacheComponents),
+                   MakeUintegerChecker<uint32_t> ())
+
+    .AddAttribute ("LpmCacheHits", "Get number of lookups answered from the LPM cache",
+                   TypeId::ATTR_GET,
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&FibImpl::GetLpmCacheHits),
+                   MakeUintegerChecker<uint64_t> ())
+
+    .AddAttribute ("LpmCacheMisses", "Get number of lookups that were not answered from the LPM cache",
+                   TypeId::ATTR_GET,
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&FibImpl::GetLpmCacheMisses),
+                   MakeUintegerChecker<uint64_t> ())
   ;
   return tid;
 }
 
 FibImpl::FibImpl ()
+  : m_lpmCacheComponents (4)
+  , m_lpmCacheGeneration (1)
+  , m_lpmCacheHits (0)
+  , m_lpmCacheMisses (0)
 {
 }
 
@@ -66,6 +103,9 @@ FibImpl::NotifyNewAggregate ()
 void 
 FibImpl::DoDispose (void)
 {
+  m_faceIndex.clear ();
+  m_prefixLengths.clear ();
+  m_lpmCache.clear ();
   clear ();
   Object::DoDispose ();
 }
@@ -74,7 +114,47 @@ FibImpl::DoDispose (void)
 Ptr<Entry>
 FibImpl::LongestPrefixMatch (const Interest &interest)
 {
-  super::iterator item = super::longest_prefix_match (interest.GetName ());
+  const Name &name = interest.GetName ();
+
+  // result of the lookup depends only on the first components of the name, up to the length
+  // of the longest FIB prefix (e.g., for /prefix/<seq> names and /prefix route, the key is /prefix)
+  uint32_t maxPrefixLength = m_prefixLengths.empty () ? 0 : m_prefixLengths.size () - 1;
+  if (m_lpmCache.empty () || maxPrefixLength > m_lpmCacheComponents)
+    return DoLongestPrefixMatch (name);
+
+  uint32_t length = std::min<uint32_t> (name.size (), maxPrefixLength);
+
+  std::size_t hash = 0;
+  Name::const_iterator component = name.begin ();
+  for (uint32_t i = 0; i < length; i++, component++)
+    {
+      boost::hash_combine (hash, *component);
+    }
+
+  LpmCacheSlot &slot = m_lpmCache[hash % m_lpmCache.size ()];
+  if (slot.m_generation == m_lpmCacheGeneration &&
+      slot.m_hash == hash &&
+      slot.m_key.size () == length &&
+      std::equal (slot.m_key.begin (), slot.m_key.end (), name.begin ()))
+    {
+      m_lpmCacheHits ++;
+      return slot.m_entry;
+    }
+
+  m_lpmCacheMisses ++;
+
+  slot.m_generation = m_lpmCacheGeneration;
+  slot.m_hash = hash;
+  slot.m_key = Name (name.GetSubComponents (length));
+  slot.m_entry = DoLongestPrefixMatch (name);
+
+  return slot.m_entry;
+}
+
+Ptr<EntryImpl>
+FibImpl::DoLongestPrefixMatch (const Name &name)
+{
+  super::iterator item = super::longest_prefix_match (name);
   // @todo use predicate to search with exclude filters
 
   if (item == super::end ())
@@ -115,16 +195,23 @@ FibImpl::Add (const Ptr<const Name> &prefix, Ptr<Face> face, int32_t metric)
           Ptr<EntryImpl> newEntry = Create<EntryImpl> (this, prefix);
           newEntry->SetTrie (result.first);
           result.first->set_payload (newEntry);
+
+          UpdatePrefixLengths (*prefix, 1);
+          InvalidateLpmCache ();
         }
   
+      bool newFace = result.first->payload ()->m_faces.find (face) == result.first->payload ()->m_faces.end ();
       super::modify (result.first,
                      ll::bind (&Entry::AddOrUpdateRoutingMetric, ll::_1, face, metric));
+      if (newFace)
+        IndexEntry (result.first->payload (), face);
 
       if (result.second)
         {
           // notify forwarding strategy about new FIB entry
           NS_ASSERT (this->GetObject<ForwardingStrategy> () != 0);
-          this->GetObject<ForwardingStrategy> ()->DidAddFibEntry (result.first->payload ());
+          Ptr<ForwardingStrategy> strategy = this->GetObject<ForwardingStrategy> ();
+          strategy->FindStrategy (result.first->payload ())->DidAddFibEntry (result.first->payload ());
         }
       
       return result.first->payload ();
@@ -143,7 +230,12 @@ FibImpl::Remove (const Ptr<const Name> &prefix)
     {
       // notify forwarding strategy about soon be removed FIB entry
       NS_ASSERT (this->GetObject<ForwardingStrategy> () != 0);
-      this->GetObject<ForwardingStrategy> ()->WillRemoveFibEntry (fibEntry->payload ());
+      Ptr<ForwardingStrategy> strategy = this->GetObject<ForwardingStrategy> ();
+      strategy->FindStrategy (fibEntry->payload ())->WillRemoveFibEntry (fibEntry->payload ());
+
+      UnindexEntry (fibEntry->payload ());
+      UpdatePrefixLengths (*prefix, -1);
+      InvalidateLpmCache ();
 
       super::erase (fibEntry);
     }
@@ -171,6 +263,8 @@ FibImpl::InvalidateAll ()
 {
   NS_LOG_FUNCTION (this->GetObject<Node> ()->GetId ());
 
+  InvalidateLpmCache ();
+
   super::parent_trie::recursive_iterator item (super::getTrie ());
   super::parent_trie::recursive_iterator end (0);
   for (; item != end; item++)
@@ -182,43 +276,156 @@ FibImpl::InvalidateAll ()
     }
 }
 
-void
-FibImpl::RemoveFace (super::parent_trie &item, Ptr<Face> face)
-{
-  if (item.payload () == 0) return;
-  NS_LOG_FUNCTION (this);
-
-  super::modify (&item,
-                 ll::bind (&Entry::RemoveFace, ll::_1, face));
-}
-
 void
 FibImpl::RemoveFromAll (Ptr<Face> face)
 {
   NS_LOG_FUNCTION (this);
 
-  std::for_each (super::parent_trie::recursive_iterator (super::getTrie ()),
-                 super::parent_trie::recursive_iterator (0), 
-                 ll::bind (&FibImpl::RemoveFace,
-                           this, ll::_1, face));
+  uint32_t id = face->GetId ();
+  if (id >= m_faceIndex.size ())
+    return;
 
-  super::parent_trie::recursive_iterator trieNode (super::getTrie ());
-  super::parent_trie::recursive_iterator end (0);
-  for (; trieNode != end; trieNode++)
+  // only entries that actually reference the face are touched
+  std::vector< Ptr<EntryImpl> > entries;
+  entries.swap (m_faceIndex[id]);
+
+  BOOST_FOREACH (Ptr<EntryImpl> entry, entries)
     {
-      if (trieNode->payload () == 0) continue;
-      
-      if (trieNode->payload ()->m_faces.size () == 0)
+      super::modify (entry->to_iterator (),
+                     ll::bind (&Entry::RemoveFace, ll::_1, face));
+
+      if (entry->m_faces.size () == 0)
         {
           // notify forwarding strategy about soon be removed FIB entry
           NS_ASSERT (this->GetObject<ForwardingStrategy> () != 0);
-          this->GetObject<ForwardingStrategy> ()->WillRemoveFibEntry (trieNode->payload ());
-          
-          trieNode = super::parent_trie::recursive_iterator (trieNode->erase ());
+          Ptr<ForwardingStrategy> strategy = this->GetObject<ForwardingStrategy> ();
+          strategy->FindStrategy (entry)->WillRemoveFibEntry (entry);
+
+          UpdatePrefixLengths (entry->GetPrefix (), -1);
+          InvalidateLpmCache ();
+
+          super::erase (entry->to_iterator ());
         }
     }
 }
 
+void
+FibImpl::FindEntriesWithFace (Ptr<Face> face, std::vector< Ptr<fib::Entry> > &entries)
+{
+  uint32_t id = face->GetId ();
+  if (id >= m_faceIndex.size ())
+    return;
+
+  entries.insert (entries.end (), m_faceIndex[id].begin (), m_faceIndex[id].end ());
+}
+
+void
+FibImpl::IndexEntry (Ptr<EntryImpl> entry, Ptr<Face> face)
+{
+  uint32_t id = face->GetId ();
+  NS_ASSERT_MSG (id != (uint32_t)-1, "Face should be added to the NDN stack before it is referenced in FIB");
+  if (m_faceIndex.size () <= id)
+    m_faceIndex.resize (id + 1);
+
+  m_faceIndex[id].push_back (entry);
+  const_cast<FaceMetric&> (*entry->m_faces.find (face)).m_indexPosition = m_faceIndex[id].size () - 1;
+}
+
+void
+FibImpl::UnindexEntry (Ptr<EntryImpl> entry, Ptr<Face> face)
+{
+  std::vector< Ptr<EntryImpl> > &entries = m_faceIndex[face->GetId ()];
+  uint32_t position = entry->m_faces.find (face)->m_indexPosition;
+  NS_ASSERT (position < entries.size () && entries[position] == entry);
+
+  if (position + 1 < entries.size ())
+    {
+      Ptr<EntryImpl> moved = entries.back ();
+      entries[position] = moved;
+      const_cast<FaceMetric&> (*moved->m_faces.find (face)).m_indexPosition = position;
+    }
+  entries.pop_back ();
+}
+
+void
+FibImpl::UnindexEntry (Ptr<EntryImpl> entry)
+{
+  BOOST_FOREACH (const FaceMetric &metric, entry->m_faces)
+    {
+      UnindexEntry (entry, metric.GetFace ());
+    }
+}
+
+void
+FibImpl::UpdatePrefixLengths (const Name &prefix, int32_t delta)
+{
+  if (delta > 0)
+    {
+      if (m_prefixLengths.size () <= prefix.size ())
+        m_prefixLengths.resize (prefix.size () + 1, 0);
+
+      m_prefixLengths[prefix.size ()] += delta;
+    }
+  else
+    {
+      NS_ASSERT (prefix.size () < m_prefixLengths.size () && m_prefixLengths[prefix.size ()] >= static_cast<uint32_t> (-delta));
+      m_prefixLengths[prefix.size ()] += delta;
+
+      while (!m_prefixLengths.empty () && m_prefixLengths.back () == 0)
+        m_prefixLengths.pop_back ();
+    }
+}
+
+void
+FibImpl::InvalidateLpmCache ()
+{
+  // stale records are not cleaned, they will fail generation check
+  m_lpmCacheGeneration ++;
+  if (m_lpmCacheGeneration == 0)
+    {
+      // wrap around, need to reset all records
+      m_lpmCache.assign (m_lpmCache.size (), LpmCacheSlot ());
+      m_lpmCacheGeneration = 1;
+    }
+}
+
+void
+FibImpl::SetLpmCacheSize (uint32_t size)
+{
+  m_lpmCache.assign (size, LpmCacheSlot ());
+}
+
+uint32_t
+FibImpl::GetLpmCacheSize () const
+{
+  return m_lpmCache.size ();
+}
+
+void
+FibImpl::SetLpmCacheComponents (uint32_t components)
+{
+  m_lpmCacheComponents = components;
+  InvalidateLpmCache ();
+}
+
+uint32_t
+FibImpl::GetLpmCacheComponents () const
+{
+  return m_lpmCacheComponents;
+}
+
+uint64_t
+FibImpl::GetLpmCacheHits () const
+{
+  return m_lpmCacheHits;
+}
+
+uint64_t
+FibImpl::GetLpmCacheMisses () const
+{
+  return m_lpmCacheMisses;
+}
+
 void
 FibImpl::Print (std::ostream &os) const
 {
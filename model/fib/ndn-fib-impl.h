@@ -27,6 +27,8 @@
 #include "../../utils/trie/trie-with-policy.h"
 #include "../../utils/trie/counting-policy.h"
 
+#include <vector>
+
 namespace ns3 {
 namespace ndn {
 namespace fib {
@@ -106,6 +108,9 @@ public:
   virtual void
   RemoveFromAll (Ptr<Face> face);
 
+  virtual void
+  FindEntriesWithFace (Ptr<Face> face, std::vector< Ptr<fib::Entry> > &entries);
+
   virtual void
   Print (std::ostream &os) const;
 
@@ -129,6 +134,18 @@ public:
   
   virtual Ptr<Entry>
   Next (Ptr<Entry> item);
+
+  /**
+   * @brief Get number of LongestPrefixMatch calls answered from the LPM cache
+   */
+  uint64_t
+  GetLpmCacheHits () const;
+
+  /**
+   * @brief Get number of LongestPrefixMatch calls that required FIB lookup
+   */
+  uint64_t
+  GetLpmCacheMisses () const;
   
 protected:
   // inherited from Object class
@@ -137,11 +154,80 @@ protected:
 
 private:
   /**
-   * @brief Remove reference to a face from the entry. If entry had only this face, the whole
-   * entry will be removed
+   * @brief Add the entry to per-face index (called when the face is added to the entry)
+   */
+  void
+  IndexEntry (Ptr<EntryImpl> entry, Ptr<Face> face);
+
+  /**
+   * @brief Remove the entry from per-face index of the face
+   *
+   * The last entry of the per-face index is moved to the vacated position (its record is updated accordingly)
+   */
+  void
+  UnindexEntry (Ptr<EntryImpl> entry, Ptr<Face> face);
+
+  /**
+   * @brief Remove the entry from per-face index for all faces of the entry
+   */
+  void
+  UnindexEntry (Ptr<EntryImpl> entry);
+
+  /**
+   * @brief Update histogram of prefix lengths when entry is added (delta=1) or removed (delta=-1)
    */
   void
-  RemoveFace (super::parent_trie &item, Ptr<Face> face);
+  UpdatePrefixLengths (const Name &prefix, int32_t delta);
+
+  /**
+   * @brief Longest prefix match lookup in the trie, bypassing the LPM cache
+   */
+  Ptr<EntryImpl>
+  DoLongestPrefixMatch (const Name &name);
+
+  /**
+   * @brief Invalidate all records in the LPM cache (constant time)
+   */
+  void
+  InvalidateLpmCache ();
+
+  void
+  SetLpmCacheSize (uint32_t size);
+
+  uint32_t
+  GetLpmCacheSize () const;
+
+  void
+  SetLpmCacheComponents (uint32_t components);
+
+  uint32_t
+  GetLpmCacheComponents () const;
+
+private:
+  typedef std::vector< std::vector< Ptr<EntryImpl> > > FaceIndex;
+
+  FaceIndex m_faceIndex; ///< @brief FIB entries that reference the face (indexed by face ID)
+
+  std::vector<uint32_t> m_prefixLengths; ///< @brief number of FIB entries for each prefix length (in components)
+
+  /**
+   * @brief Record of the direct-mapped LPM cache
+   */
+  struct LpmCacheSlot
+  {
+    LpmCacheSlot () : m_generation (0), m_hash (0) { }
+
+    uint32_t m_generation; ///< @brief record is valid only if equal to m_lpmCacheGeneration
+    std::size_t m_hash;    ///< @brief hash of the key
+    Name m_key;            ///< @brief first components of the looked up name (up to the length of the longest FIB prefix)
+    Ptr<EntryImpl> m_entry; ///< @brief result of the lookup (can be 0)
+  };
+
+  std::vector<LpmCacheSlot> m_lpmCache;
+  uint32_t m_lpmCacheComponents;
+  uint32_t m_lpmCacheGeneration;
+  uint64_t m_lpmCacheHits;
+  uint64_t m_lpmCacheMisses;
 };
 
 } // namespace fib
@@ -0,0 +1,97 @@
+/* -*- Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2013 University of California, Los Angeles
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Alexander Afanasyev <alexander.afanasyev@ucla.edu>
+ */
+
+#include "ndn-fib-next-hop-sampler.h"
+#include "ndn-fib-entry.h"
+
+#include "ns3/log.h"
+#include "ns3/assert.h"
+
+NS_LOG_COMPONENT_DEFINE ("ndn.fib.NextHopSampler");
+
+namespace ns3 {
+namespace ndn {
+namespace fib {
+
+NS_OBJECT_ENSURE_REGISTERED (NextHopSampler);
+
+TypeId
+NextHopSampler::GetTypeId ()
+{
+  static TypeId tid = TypeId ("ns3::ndn::fib::NextHopSampler")
+    .SetGroupName ("Ndn")
+    .SetParent<Object> ()
+    .AddConstructor<NextHopSampler> ()
+    ;
+  return tid;
+}
+
+NextHopSampler::NextHopSampler ()
+  : m_valid (false)
+  , m_version (0)
+{
+}
+
+Ptr<NextHopSampler>
+NextHopSampler::Get (Ptr<Entry> fibEntry)
+{
+  Ptr<NextHopSampler> sampler = fibEntry->GetObject<NextHopSampler> ();
+  if (sampler == 0)
+    {
+      sampler = CreateObject<NextHopSampler> ();
+      fibEntry->AggregateObject (sampler);
+    }
+  return sampler;
+}
+
+bool
+NextHopSampler::IsValid (const Entry &fibEntry) const
+{
+  return m_valid && m_version == fibEntry.m_faces.GetVersion ();
+}
+
+void
+NextHopSampler::Invalidate ()
+{
+  m_valid = false;
+}
+
+void
+NextHopSampler::Build (const Entry &fibEntry, const std::vector<double> &weights)
+{
+  NS_ASSERT_MSG (weights.size () == fibEntry.m_faces.size (), "There should be exactly one weight for each next hop");
+
+  m_valid = true;
+  m_version = fibEntry.m_faces.GetVersion ();
+
+  m_table.Build (weights);
+}
+
+uint32_t
+NextHopSampler::Sample (double uniform) const
+{
+  NS_ASSERT_MSG (m_valid && m_table.GetSize () > 0, "Sampling table is not built");
+
+  return m_table.Sample (uniform);
+}
+
+} // namespace fib
+} // namespace ndn
+} // namespace ns3
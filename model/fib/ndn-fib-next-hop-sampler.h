@@ -0,0 +1,111 @@
+/* -*- Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2013 University of California, Los Angeles
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Alexander Afanasyev <alexander.afanasyev@ucla.edu>
+ */
+
+#ifndef _NDN_FIB_NEXT_HOP_SAMPLER_H_
+#define	_NDN_FIB_NEXT_HOP_SAMPLER_H_
+
+#include "ns3/object.h"
+#include "ns3/ptr.h"
+#include "ns3/ndnSIM/utils/ndn-alias-table.h"
+
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+namespace fib {
+
+class Entry;
+
+/**
+ * \ingroup ndn
+ * \brief Cached table to randomly select a next hop of FIB entry according to next hop weights
+ *
+ * Sampler is aggregated to the FIB entry (see Get) and uses Walker's alias method, so each selection takes
+ * constant time, independent of the number of next hops.  Weights are supplied by a forwarding strategy, and the
+ * table needs to be rebuilt only when next hops of the FIB entry change (e.g., when NACK ratio is recalculated),
+ * which is detected using version of the FIB entry's next hop container.
+ *
+ * Usage by a probabilistic forwarding strategy:
+ *
+ * \code
+ *   Ptr<fib::NextHopSampler> sampler = fib::NextHopSampler::Get (fibEntry);
+ *   if (!sampler->IsValid (*fibEntry))
+ *     {
+ *       // weights[i] is the weight of fibEntry->m_faces.get<fib::i_nth> () [i]
+ *       sampler->Build (*fibEntry, weights);
+ *     }
+ *   const fib::FaceMetric &nextHop = fibEntry->m_faces.get<fib::i_nth> () [sampler->Sample (uniform.GetValue ())];
+ * \endcode
+ */
+class NextHopSampler : public Object
+{
+public:
+  static TypeId
+  GetTypeId ();
+
+  NextHopSampler ();
+
+  /**
+   * @brief Get sampler aggregated to the FIB entry (new sampler is created and aggregated, if necessary)
+   */
+  static Ptr<NextHopSampler>
+  Get (Ptr<Entry> fibEntry);
+
+  /**
+   * @brief Check if the table has been built for the current next hops of the FIB entry
+   */
+  bool
+  IsValid (const Entry &fibEntry) const;
+
+  /**
+   * @brief Build the table
+   * @param fibEntry FIB entry
+   * @param weights  Non-negative weights of the next hops in the rank order (get<i_nth>) of the FIB entry.
+   *                 If all weights are zero, next hops are selected uniformly.
+   */
+  void
+  Build (const Entry &fibEntry, const std::vector<double> &weights);
+
+  /**
+   * @brief Force rebuilding of the table (e.g., when the way weights are calculated has changed)
+   */
+  void
+  Invalidate ();
+
+  /**
+   * @brief Select next hop
+   * @param uniform Random value uniformly distributed in [0, 1)
+   * @returns rank of the selected next hop (index for get<i_nth>)
+   */
+  uint32_t
+  Sample (double uniform) const;
+
+private:
+  bool m_valid;
+  uint32_t m_version; ///< @brief version of the next hop container, for which the table has been built
+
+  AliasTable m_table;
+};
+
+} // namespace fib
+} // namespace ndn
+} // namespace ns3
+
+#endif // _NDN_FIB_NEXT_HOP_SAMPLER_H_
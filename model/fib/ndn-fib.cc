@@ -36,6 +36,16 @@ Fib::GetTypeId (void)
   return tid;
 }
 
+void
+Fib::FindEntriesWithFace (Ptr<Face> face, std::vector< Ptr<fib::Entry> > &entries)
+{
+  for (Ptr<fib::Entry> entry = Begin (); entry != End (); entry = Next (entry))
+    {
+      if (entry->m_faces.find (face) != entry->m_faces.end ())
+        entries.push_back (entry);
+    }
+}
+
 std::ostream&
 operator<< (std::ostream& os, const Fib &fib)
 {
@@ -26,6 +26,8 @@
 
 #include "ns3/ndn-fib-entry.h"
 
+#include <vector>
+
 namespace ns3 {
 namespace ndn {
 
@@ -136,6 +138,18 @@ public:
   virtual void
   RemoveFromAll (Ptr<Face> face) = 0;
 
+  /**
+   * @brief Find all FIB entries that have the face as one of the next hops
+   *
+   * Default implementation walks the whole FIB.  Implementations that keep per-face
+   * index should override this method.
+   *
+   * @param face face
+   * @param entries container to which found FIB entries are appended
+   */
+  virtual void
+  FindEntriesWithFace (Ptr<Face> face, std::vector< Ptr<fib::Entry> > &entries);
+
   /**
    * @brief Print out entries in FIB
    */
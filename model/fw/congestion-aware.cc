@@ -28,6 +28,7 @@
 #include "ns3/ndn-pit.h"
 #include "ns3/ndn-fib.h"
 #include "ns3/ndn-fib-entry.h"
+#include "ns3/ndn-fib-next-hop-sampler.h"
 #include "ns3/ndn-content-store.h"
 #include "ns3/random-variable.h"
 #include "ns3/ndnSIM/utils/ndn-fw-hop-count-tag.h"
@@ -86,32 +87,30 @@ CongestionAware::DoPropagateInterest (Ptr<Face> inFace,
   NS_LOG_FUNCTION (this);
   NS_ASSERT_MSG (m_pit != 0, "PIT should be aggregated with forwarding strategy");
 
-  bool success = false;
+  Ptr<fib::Entry> fibEntry = pitEntry->GetFibEntry ();
+  if (fibEntry->m_faces.empty ())
+    return false;
 
-  double total = 0.0;
-  BOOST_FOREACH (const fib::FaceMetric &metricFace, pitEntry->GetFibEntry ()->m_faces.get<fib::i_nth> ())
+  // weights change only when NACK ratios are recalculated, so the sampling table is rebuilt only then
+  Ptr<fib::NextHopSampler> sampler = fib::NextHopSampler::Get (fibEntry);
+  if (!sampler->IsValid (*fibEntry))
     {
-      if (pitEntry->GetFibEntry ()->m_faces.size () > 1)
-        NS_LOG_DEBUG (pitEntry->GetFibEntry ()->GetPrefix () << " " << metricFace.GetFace () << " NackRatio: " << metricFace.GetNackRatio ());
-      total += pow (1.0 / metricFace.GetNackRatio(), m_k);
+      m_weights.clear ();
+      BOOST_FOREACH (const fib::FaceMetric &metricFace, fibEntry->m_faces.get<fib::i_nth> ())
+        {
+          if (fibEntry->m_faces.size () > 1)
+            NS_LOG_DEBUG (fibEntry->GetPrefix () << " " << metricFace.GetFace () << " NackRatio: " << metricFace.GetNackRatio ());
+          m_weights.push_back (pow (1.0 / metricFace.GetNackRatio(), m_k));
+        }
+      sampler->Build (*fibEntry, m_weights);
     }
 
   UniformVariable r (0, 1.0);
-  double p_random = r.GetValue ();
-  double p_sum = 0;
-  BOOST_FOREACH (const fib::FaceMetric &metricFace, pitEntry->GetFibEntry ()->m_faces.get<fib::i_nth> ())
-    {
-      p_sum += pow (1.0 / metricFace.GetNackRatio(), m_k) / total;
-      if (p_random <= p_sum)
-        {
-          success = TrySendOutInterest (inFace, metricFace.GetFace (), header, origPacket, pitEntry);
-
-          if (!success && pitEntry->GetFibEntry ()->m_faces.size () > 1)
-            pitEntry->GetFibEntry ()->UpdateFaceCounter (metricFace.GetFace (), true);
+  const fib::FaceMetric &metricFace = fibEntry->m_faces.get<fib::i_nth> () [sampler->Sample (r.GetValue ())];
 
-          break;
-        }
-    }
+  bool success = TrySendOutInterest (inFace, metricFace.GetFace (), header, origPacket, pitEntry);
+  if (!success && fibEntry->m_faces.size () > 1)
+    fibEntry->UpdateFaceCounter (metricFace.GetFace (), true);
 
   return success;
 }
@@ -191,10 +190,11 @@ CongestionAware::DidExhaustForwardingOptions (Ptr<Face> inFace,
             }
         }
 
+      Face::IncrementHopCount (packet);
       BOOST_FOREACH (const pit::IncomingFace &incoming, pitEntry->GetIncoming ())
         {
           NS_LOG_DEBUG ("Send NACK for " << boost::cref (nackHeader->GetName ()) << " to " << boost::cref (*incoming.m_face));
-          incoming.m_face->Send (packet->Copy ());
+          incoming.m_face->Send (packet->Copy (), false);
 
           m_outNacks (nackHeader, incoming.m_face);
         }
@@ -23,6 +23,8 @@
 
 #include "nacks.h"
 
+#include <vector>
+
 namespace ns3 {
 namespace ndn {
 namespace fw {
@@ -65,6 +67,8 @@ protected:
 private:
   typedef Nacks super;
   uint32_t m_k;
+
+  std::vector<double> m_weights; ///< @brief scratch space to build next hop sampling tables
 };
 
 } // namespace fw
@@ -0,0 +1,47 @@
+/* -*- Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2013 University of California, Los Angeles
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Alexander Afanasyev <alexander.afanasyev@ucla.edu>
+ */
+
+#include "local-retransmissions.h"
+
+#include "ns3/ndn-l3-protocol.h"
+#include "ns3/ndn-interest.h"
+#include "ns3/ndn-content-object.h"
+
+#include "best-route.h"
+
+namespace ns3 {
+namespace ndn {
+namespace fw {
+
+template class LocalRetransmissions<BestRoute>;
+typedef LocalRetransmissions<BestRoute> LocalRetransmissionsBestRoute;
+NS_OBJECT_ENSURE_REGISTERED (LocalRetransmissionsBestRoute);
+
+#ifdef DOXYGEN
+/**
+ * \brief Strategy implementing local retransmissions on top of BestRoute strategy
+ */
+class BestRoute::LocalRetransmissions : public ::ns3::ndn::fw::LocalRetransmissions<BestRoute> { };
+#endif
+
+} // namespace fw
+} // namespace ndn
+} // namespace ns3
+
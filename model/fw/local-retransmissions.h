@@ -0,0 +1,298 @@
+/* -*- Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2013 University of California, Los Angeles
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Alexander Afanasyev <alexander.afanasyev@ucla.edu>
+ */
+
+#ifndef NDNSIM_LOCAL_RETRANSMISSIONS_H
+#define NDNSIM_LOCAL_RETRANSMISSIONS_H
+
+#include "ns3/event-id.h"
+#include "ns3/log.h"
+#include "ns3/nstime.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/ndn-pit.h"
+#include "ns3/ndn-pit-entry.h"
+#include "ns3/ndn-fib-entry.h"
+
+#include "ns3/ndn-forwarding-strategy.h"
+#include "ns3/ndn-fw-tag.h"
+
+#include <boost/foreach.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/ref.hpp>
+
+namespace ns3 {
+namespace ndn {
+namespace fw {
+
+/**
+ * \ingroup ndn
+ * \brief Strategy implementing router-side Interest retransmissions on alternative next hops
+ *
+ * Every time the Interest is forwarded, a retransmission timer is started for the PIT entry.  The timeout
+ * is based on RTT estimation of the outgoing face in the FIB entry (SRTT + 4*RTTVAR, but not less than MinTimeout).
+ * If the timer fires before Interest is satisfied, the Interest is sent to the highest-ranked
+ * non-red face that has not been tried yet for this PIT entry.  Number of such local retransmissions
+ * for a PIT entry is limited by MaxRetries.
+ *
+ * No timer is started until the outgoing face has at least one RTT sample.  Timer of a PIT entry
+ * that has been erased from PIT by the time the timer fires is ignored.
+ *
+ * The extension makes sense only for strategies that forward Interest to a subset of non-red faces
+ * (e.g., BestRoute), therefore only BestRoute::LocalRetransmissions is instantiated.
+ */
+template<class Parent>
+class LocalRetransmissions :
+    public Parent
+{
+private:
+  typedef Parent super;
+
+public:
+  /**
+   * @brief Get TypeId of the class
+   */
+  static TypeId
+  GetTypeId ();
+
+  /**
+   * @brief Helper function to retrieve logging name for the forwarding strategy
+   */
+  static std::string
+  GetLogName ();
+
+  /**
+   * @brief Default constructor
+   */
+  LocalRetransmissions ()
+  { }
+
+  /// \copydoc ForwardingStrategy::WillEraseTimedOutPendingInterest
+  virtual void
+  WillEraseTimedOutPendingInterest (Ptr<pit::Entry> pitEntry);
+
+protected:
+  /// \copydoc ForwardingStrategy::DidSendOutInterest
+  virtual void
+  DidSendOutInterest (Ptr<Face> inFace,
+                      Ptr<Face> outFace,
+                      Ptr<const Interest> header,
+                      Ptr<const Packet> origPacket,
+                      Ptr<pit::Entry> pitEntry);
+
+  /// \copydoc ForwardingStrategy::WillSatisfyPendingInterest
+  virtual void
+  WillSatisfyPendingInterest (Ptr<Face> inFace,
+                              Ptr<pit::Entry> pitEntry);
+
+private:
+  /**
+   * @brief Forwarding strategy tag keeping retransmission state of the PIT entry
+   */
+  class RetxTag : public Tag
+  {
+  public:
+    RetxTag ()
+      : m_retries (0)
+    {
+    }
+
+    virtual
+    ~RetxTag ()
+    {
+      m_event.Cancel ();
+    }
+
+    EventId m_event;               ///< @brief Retransmission timer
+    uint32_t m_retries;            ///< @brief Number of local retransmissions done for the PIT entry
+    Ptr<Face> m_inFace;            ///< @brief Incoming face of the last forwarded Interest
+    Ptr<const Packet> m_origPacket; ///< @brief Last forwarded Interest packet
+  };
+
+  /**
+   * @brief Retransmission timer handler: forward the Interest to the next untried face
+   */
+  void
+  Retransmit (Ptr<pit::Entry> pitEntry);
+
+  /**
+   * @brief Stop retransmission timer of the PIT entry (if any)
+   */
+  void
+  CancelRetransmission (Ptr<pit::Entry> pitEntry);
+
+protected:
+  static LogComponent g_log; ///< @brief Logging variable
+
+private:
+  uint32_t m_maxRetries;
+  Time m_minTimeout;
+};
+
+template<class Parent>
+LogComponent LocalRetransmissions<Parent>::g_log = LogComponent (LocalRetransmissions<Parent>::GetLogName ().c_str ());
+
+template<class Parent>
+std::string
+LocalRetransmissions<Parent>::GetLogName ()
+{
+  return super::GetLogName ()+".LocalRetransmissions";
+}
+
+template<class Parent>
+TypeId
+LocalRetransmissions<Parent>::GetTypeId (void)
+{
+  static TypeId tid = TypeId ((super::GetTypeId ().GetName ()+"::LocalRetransmissions").c_str ())
+    .SetGroupName ("Ndn")
+    .template SetParent <super> ()
+    .template AddConstructor <LocalRetransmissions> ()
+
+    .template AddAttribute ("MaxRetries", "Maximum number of local retransmissions for a PIT entry",
+                            UintegerValue (1),
+                            MakeUintegerAccessor (&LocalRetransmissions<Parent>::m_maxRetries),
+                            MakeUintegerChecker<uint32_t> ())
+
+    .template AddAttribute ("MinTimeout", "Lower bound for the retransmission timeout",
+                            StringValue ("1ms"),
+                            MakeTimeAccessor (&LocalRetransmissions<Parent>::m_minTimeout),
+                            MakeTimeChecker ())
+    ;
+  return tid;
+}
+
+template<class Parent>
+void
+LocalRetransmissions<Parent>::DidSendOutInterest (Ptr<Face> inFace,
+                                                  Ptr<Face> outFace,
+                                                  Ptr<const Interest> header,
+                                                  Ptr<const Packet> origPacket,
+                                                  Ptr<pit::Entry> pitEntry)
+{
+  super::DidSendOutInterest (inFace, outFace, header, origPacket, pitEntry);
+
+  fib::FaceMetricContainer::type::const_iterator metric =
+    pitEntry->GetFibEntry ()->m_faces.find (outFace);
+  if (metric == pitEntry->GetFibEntry ()->m_faces.end () ||
+      metric->GetSRtt ().IsZero ())
+    return; // no RTT estimation for the face yet
+
+  boost::shared_ptr<RetxTag> tag = pitEntry->template GetFwTag<RetxTag> ();
+  if (tag == boost::shared_ptr<RetxTag> ())
+    {
+      tag = boost::make_shared<RetxTag> ();
+      pitEntry->AddFwTag (tag);
+    }
+  else if (tag->m_retries >= m_maxRetries)
+    return; // retry budget is exhausted, no need for the timer
+
+  Time timeout = Max (m_minTimeout, metric->GetSRtt () + Time (4 * metric->GetRttVar ()));
+
+  tag->m_event.Cancel ();
+  tag->m_inFace = inFace;
+  tag->m_origPacket = origPacket;
+  tag->m_event = Simulator::Schedule (timeout, &LocalRetransmissions<Parent>::Retransmit, this, pitEntry);
+}
+
+template<class Parent>
+void
+LocalRetransmissions<Parent>::Retransmit (Ptr<pit::Entry> pitEntry)
+{
+  NS_LOG_FUNCTION (this << pitEntry->GetPrefix ());
+
+  boost::shared_ptr<RetxTag> tag = pitEntry->template GetFwTag<RetxTag> ();
+  if (tag == boost::shared_ptr<RetxTag> ())
+    return;
+
+  tag->m_event = EventId ();
+  if (this->m_pit->Find (pitEntry->GetPrefix ()) != pitEntry || // entry has been erased (e.g., face removal)
+      pitEntry->GetIncoming ().empty () ||
+      tag->m_retries >= m_maxRetries)
+    {
+      CancelRetransmission (pitEntry);
+      return;
+    }
+
+  tag->m_retries ++;
+
+  Ptr<Face> inFace = tag->m_inFace;
+  if (pitEntry->GetIncoming ().find (inFace) == pitEntry->GetIncoming ().end ())
+    inFace = pitEntry->GetIncoming ().begin ()->m_face; // original incoming face is gone
+
+  Ptr<const Packet> origPacket = tag->m_origPacket;
+  BOOST_FOREACH (const fib::FaceMetric &metricFace, pitEntry->GetFibEntry ()->m_faces.get<fib::i_metric> ())
+    {
+      if (metricFace.GetStatus () == fib::FaceMetric::NDN_FIB_RED) // all non-red faces are in front
+        break;
+
+      if (pitEntry->GetOutgoing ().find (metricFace.GetFace ()) != pitEntry->GetOutgoing ().end ())
+        continue; // already tried
+
+      if (this->TrySendOutInterest (inFace, metricFace.GetFace (), pitEntry->GetInterest (), origPacket, pitEntry))
+        {
+          NS_LOG_DEBUG ("Retransmitted to " << boost::cref (*metricFace.GetFace ()));
+          return;
+        }
+    }
+
+  NS_LOG_DEBUG ("No alternative faces to retransmit");
+}
+
+template<class Parent>
+void
+LocalRetransmissions<Parent>::CancelRetransmission (Ptr<pit::Entry> pitEntry)
+{
+  boost::shared_ptr<RetxTag> tag = pitEntry->template GetFwTag<RetxTag> ();
+  if (tag != boost::shared_ptr<RetxTag> ())
+    {
+      // event holds a reference to the PIT entry, release it
+      tag->m_event.Cancel ();
+      tag->m_event = EventId ();
+      tag->m_inFace = 0;
+      tag->m_origPacket = 0;
+    }
+}
+
+template<class Parent>
+void
+LocalRetransmissions<Parent>::WillEraseTimedOutPendingInterest (Ptr<pit::Entry> pitEntry)
+{
+  NS_LOG_FUNCTION (this << pitEntry->GetPrefix ());
+
+  CancelRetransmission (pitEntry);
+  super::WillEraseTimedOutPendingInterest (pitEntry);
+}
+
+template<class Parent>
+void
+LocalRetransmissions<Parent>::WillSatisfyPendingInterest (Ptr<Face> inFace,
+                                                          Ptr<pit::Entry> pitEntry)
+{
+  NS_LOG_FUNCTION (this << pitEntry->GetPrefix ());
+
+  CancelRetransmission (pitEntry);
+  super::WillSatisfyPendingInterest (inFace, pitEntry);
+}
+
+} // namespace fw
+} // namespace ndn
+} // namespace ns3
+
+#endif // NDNSIM_LOCAL_RETRANSMISSIONS_H
@@ -0,0 +1,194 @@
+/* -*- Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2013 University of California, Los Angeles
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Alexander Afanasyev <alexander.afanasyev@ucla.edu>
+ */
+
+#include "lowest-rtt.h"
+
+#include "ns3/ndn-interest.h"
+#include "ns3/ndn-pit.h"
+#include "ns3/ndn-pit-entry.h"
+#include "ns3/ndn-fib-entry.h"
+
+#include "ns3/assert.h"
+#include "ns3/log.h"
+#include "ns3/double.h"
+
+#include <boost/foreach.hpp>
+#include <boost/ref.hpp>
+
+namespace ns3 {
+namespace ndn {
+namespace fw {
+
+NS_OBJECT_ENSURE_REGISTERED (LowestRtt);
+
+LogComponent LowestRtt::g_log = LogComponent (LowestRtt::GetLogName ().c_str ());
+
+std::string
+LowestRtt::GetLogName ()
+{
+  return super::GetLogName ()+".LowestRtt";
+}
+
+TypeId
+LowestRtt::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::ndn::fw::LowestRtt")
+    .SetGroupName ("Ndn")
+    .SetParent <super> ()
+    .AddConstructor <LowestRtt> ()
+
+    .AddAttribute ("ProbingFraction", "Fraction of Interests that are additionally sent to an alternative face to measure its RTT",
+                   DoubleValue (0.05),
+                   MakeDoubleAccessor (&LowestRtt::m_probingFraction),
+                   MakeDoubleChecker<double> (0.0, 1.0))
+    ;
+  return tid;
+}
+
+LowestRtt::LowestRtt ()
+  : m_probeCredit (0)
+  , m_probeIndex (0)
+{
+}
+
+bool
+LowestRtt::DoPropagateInterest (Ptr<Face> inFace,
+                                Ptr<const Interest> header,
+                                Ptr<const Packet> origPacket,
+                                Ptr<pit::Entry> pitEntry)
+{
+  NS_LOG_FUNCTION (this << header->GetName ());
+
+  // green faces (that recently returned Data) are preferred to yellow ones (e.g., that have recently timed out),
+  // as smoothed RTT of a face that went silent is not updated; faces are iterated in the rank order,
+  // so among faces with equal status and RTT the higher-ranked one is selected
+  const fib::FaceMetric *best = 0;
+  BOOST_FOREACH (const fib::FaceMetric &metricFace, pitEntry->GetFibEntry ()->m_faces.get<fib::i_metric> ())
+    {
+      if (metricFace.GetStatus () == fib::FaceMetric::NDN_FIB_RED) // all non-red faces are in front
+        break;
+
+      if (metricFace.GetFace () == inFace || metricFace.GetSRtt ().IsZero ())
+        continue;
+
+      if (best == 0 ||
+          metricFace.GetStatus () < best->GetStatus () ||
+          (metricFace.GetStatus () == best->GetStatus () && metricFace.GetSRtt () < best->GetSRtt ()))
+        best = &metricFace;
+    }
+
+  Ptr<Face> primaryFace;
+  if (best != 0 && TrySendOutInterest (inFace, best->GetFace (), header, origPacket, pitEntry))
+    {
+      primaryFace = best->GetFace ();
+    }
+  else
+    {
+      // no measured faces (or the best one cannot be used), fall back to the routing rank
+      BOOST_FOREACH (const fib::FaceMetric &metricFace, pitEntry->GetFibEntry ()->m_faces.get<fib::i_metric> ())
+        {
+          if (metricFace.GetStatus () == fib::FaceMetric::NDN_FIB_RED)
+            break;
+
+          if (TrySendOutInterest (inFace, metricFace.GetFace (), header, origPacket, pitEntry))
+            {
+              primaryFace = metricFace.GetFace ();
+              break;
+            }
+        }
+    }
+
+  if (primaryFace == 0)
+    {
+      NS_LOG_INFO ("Interest cannot be forwarded");
+      return false;
+    }
+  NS_LOG_INFO ("Forwarded to " << boost::cref (*primaryFace));
+
+  m_probeCredit += m_probingFraction;
+  if (m_probeCredit >= 1.0)
+    {
+      m_probeCredit -= 1.0;
+      Probe (inFace, primaryFace, header, origPacket, pitEntry);
+    }
+
+  return true;
+}
+
+bool
+LowestRtt::Probe (Ptr<Face> inFace,
+                  Ptr<Face> primaryFace,
+                  Ptr<const Interest> header,
+                  Ptr<const Packet> origPacket,
+                  Ptr<pit::Entry> pitEntry)
+{
+  // two passes over the next hops: count the candidates, then select one of them in round-robin order
+  uint32_t measured = 0;
+  uint32_t unmeasured = 0;
+  BOOST_FOREACH (const fib::FaceMetric &metricFace, pitEntry->GetFibEntry ()->m_faces.get<fib::i_metric> ())
+    {
+      if (metricFace.GetStatus () == fib::FaceMetric::NDN_FIB_RED)
+        break;
+
+      if (metricFace.GetFace () == inFace || metricFace.GetFace () == primaryFace)
+        continue;
+
+      if (metricFace.GetSRtt ().IsZero ())
+        unmeasured ++;
+      else
+        measured ++;
+    }
+
+  if (measured + unmeasured == 0)
+    return false;
+
+  // unmeasured and measured faces are probed in turns, so a face that never returns Data (and stays unmeasured)
+  // cannot take all the probes
+  uint32_t probe = m_probeIndex++;
+  bool probeUnmeasured = unmeasured > 0 && (measured == 0 || probe % 2 == 0);
+  if (unmeasured > 0 && measured > 0)
+    probe /= 2;
+  uint32_t n = probe % (probeUnmeasured ? unmeasured : measured);
+
+  BOOST_FOREACH (const fib::FaceMetric &metricFace, pitEntry->GetFibEntry ()->m_faces.get<fib::i_metric> ())
+    {
+      if (metricFace.GetStatus () == fib::FaceMetric::NDN_FIB_RED)
+        break;
+
+      if (metricFace.GetFace () == inFace || metricFace.GetFace () == primaryFace ||
+          metricFace.GetSRtt ().IsZero () != probeUnmeasured)
+        continue;
+
+      if (n > 0)
+        {
+          n --;
+          continue;
+        }
+
+      NS_LOG_DEBUG ("Probing " << boost::cref (metricFace));
+      return TrySendOutInterest (inFace, metricFace.GetFace (), header, origPacket, pitEntry);
+    }
+
+  return false;
+}
+
+} // namespace fw
+} // namespace ndn
+} // namespace ns3
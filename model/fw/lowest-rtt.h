@@ -0,0 +1,98 @@
+/* -*- Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2013 University of California, Los Angeles
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Alexander Afanasyev <alexander.afanasyev@ucla.edu>
+ */
+
+#ifndef NDNSIM_LOWEST_RTT_H
+#define NDNSIM_LOWEST_RTT_H
+
+#include "green-yellow-red.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+namespace ndn {
+namespace fw {
+
+/**
+ * \ingroup ndn
+ * \brief Strategy forwarding Interests to the face with the lowest measured RTT
+ *
+ * Interest is sent to the non-red face with the lowest smoothed RTT (as measured by fib::FaceMetric), green faces
+ * being preferred to yellow ones (smoothed RTT is not updated when Interests time out, so a face that went silent
+ * is selected only if there are no green alternatives).  Faces without RTT samples are not used as the primary
+ * next hop while at least one face is measured (if no face is measured, the strategy behaves as BestRoute).
+ *
+ * A fraction of Interests (ProbingFraction) is additionally sent to one alternative face to refresh its RTT
+ * estimation.  Unmeasured and measured alternatives are probed in turns, each group in round-robin order.
+ * Probes are spaced deterministically (every 1/ProbingFraction Interests), so probing requires neither
+ * random number draws nor any per-Interest state.
+ */
+class LowestRtt :
+    public GreenYellowRed
+{
+private:
+  typedef GreenYellowRed super;
+
+public:
+  static TypeId
+  GetTypeId ();
+
+  /**
+   * @brief Helper function to retrieve logging name for the forwarding strategy
+   */
+  static std::string
+  GetLogName ();
+
+  /**
+   * @brief Default constructor
+   */
+  LowestRtt ();
+
+  // from super
+  virtual bool
+  DoPropagateInterest (Ptr<Face> incomingFace,
+                       Ptr<const Interest> header,
+                       Ptr<const Packet> origPacket,
+                       Ptr<pit::Entry> pitEntry);
+
+private:
+  /**
+   * @brief Send a probe copy of the Interest to one of the alternative faces (except the primary one)
+   */
+  bool
+  Probe (Ptr<Face> inFace,
+         Ptr<Face> primaryFace,
+         Ptr<const Interest> header,
+         Ptr<const Packet> origPacket,
+         Ptr<pit::Entry> pitEntry);
+
+protected:
+  static LogComponent g_log;
+
+private:
+  double m_probingFraction;
+
+  double m_probeCredit;  ///< @brief accumulated fraction of Interests to be probed
+  uint32_t m_probeIndex; ///< @brief round-robin counter for the selection of probed faces
+};
+
+} // namespace fw
+} // namespace ndn
+} // namespace ns3
+
+#endif // NDNSIM_LOWEST_RTT_H
@@ -26,6 +26,7 @@
 #include "ns3/ndn-content-object.h"
 #include "ns3/ndn-pit.h"
 #include "ns3/ndn-fib.h"
+#include "ns3/ndn-fib-entry.h"
 #include "ns3/ndn-content-store.h"
 #include "ns3/ndnSIM/utils/ndn-fw-hop-count-tag.h"
 
@@ -100,7 +101,12 @@ Nacks::OnNack (Ptr<Face> inFace,
       return;
     }
 
-  DidReceiveValidNack (inFace, header->GetNack (), header, origPacket, pitEntry);
+  // NACK is processed by the strategy responsible for the PIT entry (see SetStrategyChoice)
+  Nacks *strategy = dynamic_cast<Nacks *> (FindStrategy (pitEntry->GetFibEntry ()));
+  if (strategy == 0)
+    strategy = this;
+
+  strategy->DidReceiveValidNack (inFace, header->GetNack (), header, origPacket, pitEntry);
 }
 
 void
@@ -157,10 +163,11 @@ Nacks::DidExhaustForwardingOptions (Ptr<Face> inFace,
           NS_LOG_DEBUG ("No FwHopCountTag tag associated with original Interest");
         }
 
+      Face::IncrementHopCount (packet);
       BOOST_FOREACH (const pit::IncomingFace &incoming, pitEntry->GetIncoming ())
         {
           NS_LOG_DEBUG ("Send NACK for " << boost::cref (nackHeader->GetName ()) << " to " << boost::cref (*incoming.m_face));
-          incoming.m_face->Send (packet->Copy ());
+          incoming.m_face->Send (packet->Copy (), false);
 
           m_outNacks (nackHeader, incoming.m_face);
         }
@@ -0,0 +1,207 @@
+/* -*- Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2013 University of California, Los Angeles
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Alexander Afanasyev <alexander.afanasyev@ucla.edu>
+ */
+
+#ifndef NDN_FORWARDING_STRATEGY_PIPELINE_H
+#define NDN_FORWARDING_STRATEGY_PIPELINE_H
+
+#include "ndn-forwarding-strategy.h"
+
+#include "ns3/ndn-pit.h"
+#include "ns3/ndn-pit-entry.h"
+#include "ns3/ndn-interest.h"
+#include "ns3/ndn-content-object.h"
+#include "ns3/ndn-content-store.h"
+#include "ns3/ndn-face.h"
+
+#include "ns3/assert.h"
+#include "ns3/ptr.h"
+
+#include "ns3/ndnSIM/utils/ndn-fw-hop-count-tag.h"
+
+#include <boost/foreach.hpp>
+#include <boost/tuple/tuple.hpp>
+
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+
+template<class Hooks>
+void
+ForwardingStrategy::ProcessInterest (Hooks &hooks,
+                                     Ptr<Face> inFace,
+                                     Ptr<const Interest> header,
+                                     Ptr<const Packet> origPacket,
+                                     Ptr<pit::Entry> pitEntry,
+                                     bool similarInterest)
+{
+  if (pitEntry == 0)
+    {
+      hooks.FailedToCreatePitEntry (inFace, header, origPacket);
+      return;
+    }
+
+  if (!similarInterest)
+    {
+      hooks.DidCreatePitEntry (inFace, header, origPacket, pitEntry);
+    }
+
+  bool isDuplicated = true;
+  if (!pitEntry->IsNonceSeen (header->GetNonce ()))
+    {
+      pitEntry->AddSeenNonce (header->GetNonce ());
+      isDuplicated = false;
+    }
+
+  if (isDuplicated)
+    {
+      hooks.DidReceiveDuplicateInterest (inFace, header, origPacket, pitEntry);
+      return;
+    }
+
+  Ptr<Packet> contentObject;
+  Ptr<const ContentObject> contentObjectHeader; // used for tracing
+  Ptr<const Packet> payload; // used for tracing
+  boost::tie (contentObject, contentObjectHeader, payload) = m_contentStore->Lookup (header);
+  if (contentObject != 0)
+    {
+      NS_ASSERT (contentObjectHeader != 0);
+
+      FwHopCountTag hopCountTag;
+      if (origPacket->PeekPacketTag (hopCountTag))
+        {
+          contentObject->AddPacketTag (hopCountTag);
+        }
+
+      pitEntry->AddIncoming (inFace/*, Seconds (1.0)*/);
+
+      // Do data plane performance measurements
+      hooks.WillSatisfyPendingInterest (0, pitEntry);
+
+      // Actually satisfy pending interest
+      hooks.SatisfyPendingInterest (0, contentObjectHeader, payload, contentObject, pitEntry);
+      return;
+    }
+
+  if (similarInterest && hooks.ShouldSuppressIncomingInterest (inFace, header, origPacket, pitEntry))
+    {
+      pitEntry->AddIncoming (inFace/*, header->GetInterestLifetime ()*/);
+      // update PIT entry lifetime
+      pitEntry->UpdateLifetime (header->GetInterestLifetime ());
+
+      // Suppress this interest if we're still expecting data from some other face
+      LogSuppressedInterest ();
+      m_dropInterests (header, inFace);
+
+      hooks.DidSuppressSimilarInterest (inFace, header, origPacket, pitEntry);
+      return;
+    }
+
+  if (similarInterest)
+    {
+      hooks.DidForwardSimilarInterest (inFace, header, origPacket, pitEntry);
+    }
+
+  hooks.PropagateInterest (inFace, header, origPacket, pitEntry);
+}
+
+template<class Hooks>
+void
+ForwardingStrategy::ProcessData (Hooks &hooks,
+                                 Ptr<Face> inFace,
+                                 Ptr<const ContentObject> header,
+                                 Ptr<Packet> payload,
+                                 Ptr<const Packet> origPacket,
+                                 bool didCreateCacheEntry,
+                                 const std::vector< Ptr<pit::Entry> > &pitEntries)
+{
+  if (pitEntries.empty ())
+    {
+      hooks.DidReceiveUnsolicitedData (inFace, header, payload, origPacket, didCreateCacheEntry);
+      return;
+    }
+
+  hooks.DidReceiveSolicitedData (inFace, header, payload, origPacket, didCreateCacheEntry);
+
+  BOOST_FOREACH (Ptr<pit::Entry> pitEntry, pitEntries)
+    {
+      if (pitEntry->GetIncoming ().empty ())
+        continue; // entry has been already satisfied or erased in the meantime
+
+      // Do data plane performance measurements
+      hooks.WillSatisfyPendingInterest (inFace, pitEntry);
+
+      // Actually satisfy pending interest
+      hooks.SatisfyPendingInterest (inFace, header, payload, origPacket, pitEntry);
+    }
+}
+
+template<class Hooks>
+bool
+ForwardingStrategy::ProcessSendOutInterest (Hooks &hooks,
+                                            Ptr<Face> inFace,
+                                            Ptr<Face> outFace,
+                                            Ptr<const Interest> header,
+                                            Ptr<const Packet> origPacket,
+                                            Ptr<pit::Entry> pitEntry)
+{
+  if (!hooks.CanSendOutInterest (inFace, outFace, header, origPacket, pitEntry))
+    {
+      return false;
+    }
+
+  //transmission
+  bool successSend;
+  if (m_fanOut != 0 && m_fanOut->m_origPacket == origPacket && m_fanOut->m_sent)
+    {
+      // the Interest is sent on more than one face: update hop count once and share the updated packet
+      if (m_fanOut->m_packet == 0)
+        {
+          m_fanOut->m_packet = origPacket->Copy ();
+          Face::IncrementHopCount (m_fanOut->m_packet);
+        }
+      successSend = outFace->Send (m_fanOut->m_packet->Copy (), false);
+    }
+  else
+    {
+      // the first (usually, the only) face for the Interest, hop count is updated by the face
+      if (m_fanOut != 0 && m_fanOut->m_origPacket == origPacket)
+        {
+          m_fanOut->m_sent = true;
+        }
+      successSend = outFace->Send (origPacket->Copy ());
+    }
+
+  if (!successSend)
+    {
+      m_dropInterests (header, outFace);
+      return false;
+    }
+
+  pitEntry->AddOutgoing (outFace);
+  hooks.DidSendOutInterest (inFace, outFace, header, origPacket, pitEntry);
+
+  return true;
+}
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // NDN_FORWARDING_STRATEGY_PIPELINE_H
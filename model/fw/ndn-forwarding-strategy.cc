@@ -20,6 +20,7 @@
  */
 
 #include "ndn-forwarding-strategy.h"
+#include "ndn-forwarding-strategy-pipeline.h"
 
 #include "ns3/ndn-pit.h"
 #include "ns3/ndn-pit-entry.h"
@@ -27,6 +28,7 @@
 #include "ns3/ndn-content-object.h"
 #include "ns3/ndn-pit.h"
 #include "ns3/ndn-fib.h"
+#include "ns3/ndn-fib-entry.h"
 #include "ns3/ndn-content-store.h"
 #include "ns3/ndn-face.h"
 
@@ -49,6 +51,37 @@ namespace ll = boost::lambda;
 namespace ns3 {
 namespace ndn {
 
+namespace {
+// helpers to relay traces of namespace-specific strategies to the traces of the main strategy
+template<class T1>
+void
+RelayTrace1 (TracedCallback<T1> *trace, T1 a1)
+{
+  (*trace) (a1);
+}
+
+template<class T1, class T2>
+void
+RelayTrace2 (TracedCallback<T1, T2> *trace, T1 a1, T2 a2)
+{
+  (*trace) (a1, a2);
+}
+
+template<class T1, class T2, class T3>
+void
+RelayTrace3 (TracedCallback<T1, T2, T3> *trace, T1 a1, T2 a2, T3 a3)
+{
+  (*trace) (a1, a2, a3);
+}
+
+template<class T1, class T2, class T3, class T4>
+void
+RelayTrace4 (TracedCallback<T1, T2, T3, T4> *trace, T1 a1, T2 a2, T3 a3, T4 a4)
+{
+  (*trace) (a1, a2, a3, a4);
+}
+}
+
 NS_OBJECT_ENSURE_REGISTERED (ForwardingStrategy);
 
 NS_LOG_COMPONENT_DEFINE (ForwardingStrategy::GetLogName ().c_str ());
@@ -105,6 +138,7 @@ TypeId ForwardingStrategy::GetTypeId (void)
 }
 
 ForwardingStrategy::ForwardingStrategy ()
+  : m_fanOut (0)
 {
 }
 
@@ -128,6 +162,13 @@ ForwardingStrategy::NotifyNewAggregate ()
       m_contentStore = GetObject<ContentStore> ();
     }
 
+  BOOST_FOREACH (const StrategyChoice::value_type &choice, m_strategyChoice)
+    {
+      choice.second->m_pit = m_pit;
+      choice.second->m_fib = m_fib;
+      choice.second->m_contentStore = m_contentStore;
+    }
+
   Object::NotifyNewAggregate ();
 }
 
@@ -138,6 +179,12 @@ ForwardingStrategy::DoDispose ()
   m_contentStore = 0;
   m_fib = 0;
 
+  BOOST_FOREACH (const StrategyChoice::value_type &choice, m_strategyChoice)
+    {
+      choice.second->Dispose ();
+    }
+  m_strategyChoice.clear ();
+
   Object::DoDispose ();
 }
 
@@ -154,74 +201,10 @@ ForwardingStrategy::OnInterest (Ptr<Face> inFace,
     {
       similarInterest = false;
       pitEntry = m_pit->Create (header);
-      if (pitEntry != 0)
-        {
-          DidCreatePitEntry (inFace, header, origPacket, pitEntry);
-        }
-      else
-        {
-          FailedToCreatePitEntry (inFace, header, origPacket);
-          return;
-        }
-    }
-
-  bool isDuplicated = true;
-  if (!pitEntry->IsNonceSeen (header->GetNonce ()))
-    {
-      pitEntry->AddSeenNonce (header->GetNonce ());
-      isDuplicated = false;
-    }
-
-  if (isDuplicated)
-    {
-      DidReceiveDuplicateInterest (inFace, header, origPacket, pitEntry);
-      return;
     }
 
-  Ptr<Packet> contentObject;
-  Ptr<const ContentObject> contentObjectHeader; // used for tracing
-  Ptr<const Packet> payload; // used for tracing
-  boost::tie (contentObject, contentObjectHeader, payload) = m_contentStore->Lookup (header);
-  if (contentObject != 0)
-    {
-      NS_ASSERT (contentObjectHeader != 0);
-
-      FwHopCountTag hopCountTag;
-      if (origPacket->PeekPacketTag (hopCountTag))
-        {
-          contentObject->AddPacketTag (hopCountTag);
-        }
-
-      pitEntry->AddIncoming (inFace/*, Seconds (1.0)*/);
-
-      // Do data plane performance measurements
-      WillSatisfyPendingInterest (0, pitEntry);
-
-      // Actually satisfy pending interest
-      SatisfyPendingInterest (0, contentObjectHeader, payload, contentObject, pitEntry);
-      return;
-    }
-
-  if (similarInterest && ShouldSuppressIncomingInterest (inFace, header, origPacket, pitEntry))
-    {
-      pitEntry->AddIncoming (inFace/*, header->GetInterestLifetime ()*/);
-      // update PIT entry lifetime
-      pitEntry->UpdateLifetime (header->GetInterestLifetime ());
-
-      // Suppress this interest if we're still expecting data from some other face
-      NS_LOG_DEBUG ("Suppress interests");
-      m_dropInterests (header, inFace);
-
-      DidSuppressSimilarInterest (inFace, header, origPacket, pitEntry);
-      return;
-    }
-
-  if (similarInterest)
-    {
-      DidForwardSimilarInterest (inFace, header, origPacket, pitEntry);
-    }
-
-  PropagateInterest (inFace, header, origPacket, pitEntry);
+  ForwardingStrategy *strategy = (pitEntry != 0) ? FindStrategy (pitEntry->GetFibEntry ()) : this;
+  strategy->HandleInterest (inFace, header, origPacket, pitEntry, similarInterest);
 }
 
 void
@@ -233,12 +216,13 @@ ForwardingStrategy::OnData (Ptr<Face> inFace,
   NS_LOG_FUNCTION (inFace << header->GetName () << payload << origPacket);
   m_inData (header, payload, inFace);
 
-  // Lookup PIT entry
-  Ptr<pit::Entry> pitEntry = m_pit->Lookup (*header);
-  if (pitEntry == 0)
-    {
-      bool cached = false;
+  // Lookup all PIT entries that can be satisfied by the data packet
+  std::vector< Ptr<pit::Entry> > pitEntries;
+  m_pit->LookupAll (*header, pitEntries);
 
+  bool cached = false;
+  if (pitEntries.empty ())
+    {
       if (m_cacheUnsolicitedData || (m_cacheUnsolicitedDataFromApps && (inFace->GetFlags () | Face::APPLICATION)))
         {
           FwHopCountTag hopCountTag;
@@ -258,50 +242,79 @@ ForwardingStrategy::OnData (Ptr<Face> inFace,
           m_dropData (header, payload, inFace);
         }
 
-      DidReceiveUnsolicitedData (inFace, header, payload, origPacket, cached);
+      HandleData (inFace, header, payload, origPacket, cached, pitEntries);
       return;
     }
-  else
+
+  FwHopCountTag hopCountTag;
+  if (payload->PeekPacketTag (hopCountTag))
     {
-      bool cached = false;
+      Ptr<Packet> payloadCopy = payload->Copy ();
+      payloadCopy->RemovePacketTag (hopCountTag);
 
-      FwHopCountTag hopCountTag;
-      if (payload->PeekPacketTag (hopCountTag))
-        {
-          Ptr<Packet> payloadCopy = payload->Copy ();
-          payloadCopy->RemovePacketTag (hopCountTag);
+      // Add or update entry in the content store
+      cached = m_contentStore->Add (header, payloadCopy);
+    }
+  else
+    {
+      // Add or update entry in the content store
+      cached = m_contentStore->Add (header, payload); // no need for extra copy
+    }
 
-          // Add or update entry in the content store
-          cached = m_contentStore->Add (header, payloadCopy);
-        }
-      else
-        {
-          // Add or update entry in the content store
-          cached = m_contentStore->Add (header, payload); // no need for extra copy
-        }
+  if (m_strategyChoice.empty ())
+    {
+      HandleData (inFace, header, payload, origPacket, cached, pitEntries);
+      return;
+    }
 
-      DidReceiveSolicitedData (inFace, header, payload, origPacket, cached);
+  // Each strategy processes only PIT entries it is responsible for
+  std::vector<ForwardingStrategy *> strategies;
+  strategies.reserve (pitEntries.size ());
+  BOOST_FOREACH (Ptr<pit::Entry> pitEntry, pitEntries)
+    {
+      strategies.push_back (FindStrategy (pitEntry->GetFibEntry ()));
     }
 
-  while (pitEntry != 0)
+  std::vector< Ptr<pit::Entry> > group;
+  for (size_t i = 0; i < pitEntries.size (); i++)
     {
-      // Do data plane performance measurements
-      WillSatisfyPendingInterest (inFace, pitEntry);
+      ForwardingStrategy *strategy = strategies[i];
+      if (strategy == 0)
+        continue; // already processed as part of an earlier group
 
-      // Actually satisfy pending interest
-      SatisfyPendingInterest (inFace, header, payload, origPacket, pitEntry);
+      group.clear ();
+      for (size_t j = i; j < pitEntries.size (); j++)
+        {
+          if (strategies[j] == strategy)
+            {
+              group.push_back (pitEntries[j]);
+              strategies[j] = 0;
+            }
+        }
 
-      // Lookup another PIT entry
-      pitEntry = m_pit->Lookup (*header);
+      strategy->HandleData (inFace, header, payload, origPacket, cached, group);
     }
 }
 
 void
-ForwardingStrategy::DidCreatePitEntry (Ptr<Face> inFace,
-                                       Ptr<const Interest> header,
-                                       Ptr<const Packet> origPacket,
-                                       Ptr<pit::Entry> pitEntrypitEntry)
+ForwardingStrategy::HandleInterest (Ptr<Face> inFace,
+                                    Ptr<const Interest> header,
+                                    Ptr<const Packet> origPacket,
+                                    Ptr<pit::Entry> pitEntry,
+                                    bool similarInterest)
 {
+  ProcessInterest (*this, inFace, header, origPacket, pitEntry, similarInterest);
+}
+
+void
+ForwardingStrategy::HandleData (Ptr<Face> inFace,
+                                Ptr<const ContentObject> header,
+                                Ptr<Packet> payload,
+                                Ptr<const Packet> origPacket,
+                                bool didCreateCacheEntry,
+                                const std::vector< Ptr<pit::Entry> > &pitEntries)
+{
+  ProcessData (*this, inFace, header, payload, origPacket, didCreateCacheEntry, pitEntries);
 }
 
 void
@@ -327,22 +340,6 @@ ForwardingStrategy::DidReceiveDuplicateInterest (Ptr<Face> inFace,
   m_dropInterests (header, inFace);
 }
 
-void
-ForwardingStrategy::DidSuppressSimilarInterest (Ptr<Face> face,
-                                                Ptr<const Interest> header,
-                                                Ptr<const Packet> origPacket,
-                                                Ptr<pit::Entry> pitEntry)
-{
-}
-
-void
-ForwardingStrategy::DidForwardSimilarInterest (Ptr<Face> inFace,
-                                               Ptr<const Interest> header,
-                                               Ptr<const Packet> origPacket,
-                                               Ptr<pit::Entry> pitEntry)
-{
-}
-
 void
 ForwardingStrategy::DidExhaustForwardingOptions (Ptr<Face> inFace,
                                                  Ptr<const Interest> header,
@@ -396,10 +393,22 @@ ForwardingStrategy::SatisfyPendingInterest (Ptr<Face> inFace,
   if (inFace != 0)
     pitEntry->RemoveIncoming (inFace);
 
+  // hop count is updated only once; all incoming faces get copies that share the updated packet,
+  // and the last face gets the updated packet itself
+  Ptr<Packet> packet;
+  uint32_t remaining = pitEntry->GetIncoming ().size ();
+
   //satisfy all pending incoming Interests
   BOOST_FOREACH (const pit::IncomingFace &incoming, pitEntry->GetIncoming ())
     {
-      bool ok = incoming.m_face->Send (origPacket->Copy ());
+      if (packet == 0)
+        {
+          packet = origPacket->Copy ();
+          Face::IncrementHopCount (packet);
+        }
+      remaining --;
+
+      bool ok = incoming.m_face->Send (remaining > 0 ? packet->Copy () : packet, false);
 
       DidSendOutData (inFace, incoming.m_face, header, payload, origPacket, pitEntry);
       NS_LOG_DEBUG ("Satisfy " << *incoming.m_face);
@@ -421,26 +430,6 @@ ForwardingStrategy::SatisfyPendingInterest (Ptr<Face> inFace,
   m_pit->MarkErased (pitEntry);
 }
 
-void
-ForwardingStrategy::DidReceiveSolicitedData (Ptr<Face> inFace,
-                                             Ptr<const ContentObject> header,
-                                             Ptr<const Packet> payload,
-                                             Ptr<const Packet> origPacket,
-                                             bool didCreateCacheEntry)
-{
-  // do nothing
-}
-
-void
-ForwardingStrategy::DidReceiveUnsolicitedData (Ptr<Face> inFace,
-                                               Ptr<const ContentObject> header,
-                                               Ptr<const Packet> payload,
-                                               Ptr<const Packet> origPacket,
-                                               bool didCreateCacheEntry)
-{
-  // do nothing
-}
-
 void
 ForwardingStrategy::WillSatisfyPendingInterest (Ptr<Face> inFace,
                                                 Ptr<pit::Entry> pitEntry)
@@ -504,6 +493,14 @@ ForwardingStrategy::PropagateInterest (Ptr<Face> inFace,
   /// @todo Make lifetime per incoming interface
   pitEntry->UpdateLifetime (header->GetInterestLifetime ());
 
+  // packet with updated hop count is prepared only if the Interest goes out on more than one face
+  // (see ProcessSendOutInterest); previous fan-out is restored in case PropagateInterest is re-entered
+  FanOut fanOut;
+  fanOut.m_origPacket = origPacket;
+  fanOut.m_sent = false;
+  FanOut *outerFanOut = m_fanOut;
+  m_fanOut = &fanOut;
+
   bool propagated = DoPropagateInterest (inFace, header, origPacket, pitEntry);
 
   if (!propagated && isRetransmitted) //give another chance if retransmitted
@@ -515,6 +512,8 @@ ForwardingStrategy::PropagateInterest (Ptr<Face> inFace,
       propagated = DoPropagateInterest (inFace, header, origPacket, pitEntry);
     }
 
+  m_fanOut = outerFanOut;
+
   // if (!propagated)
   //   {
   //     NS_LOG_DEBUG ("++++++++++++++++++++++++++++++++++++++++++++++++++++++");
@@ -562,6 +561,12 @@ ForwardingStrategy::CanSendOutInterest (Ptr<Face> inFace,
 }
 
 
+void
+ForwardingStrategy::LogSuppressedInterest ()
+{
+  NS_LOG_DEBUG ("Suppress interests");
+}
+
 bool
 ForwardingStrategy::TrySendOutInterest (Ptr<Face> inFace,
                                         Ptr<Face> outFace,
@@ -569,24 +574,7 @@ ForwardingStrategy::TrySendOutInterest (Ptr<Face> inFace,
                                         Ptr<const Packet> origPacket,
                                         Ptr<pit::Entry> pitEntry)
 {
-  if (!CanSendOutInterest (inFace, outFace, header, origPacket, pitEntry))
-    {
-      return false;
-    }
-
-  //transmission
-  Ptr<Packet> packetToSend = origPacket->Copy ();
-  bool successSend = outFace->Send (packetToSend);
-  if (!successSend)
-    {
-      m_dropInterests (header, outFace);
-      return false;
-    }
-
-  pitEntry->AddOutgoing (outFace);
-  DidSendOutInterest (inFace, outFace, header, origPacket, pitEntry);
-
-  return true;
+  return ProcessSendOutInterest (*this, inFace, outFace, header, origPacket, pitEntry);
 }
 
 void
@@ -619,25 +607,93 @@ ForwardingStrategy::WillEraseTimedOutPendingInterest (Ptr<pit::Entry> pitEntry)
 void
 ForwardingStrategy::AddFace (Ptr<Face> face)
 {
-  // do nothing here
+  BOOST_FOREACH (const StrategyChoice::value_type &choice, m_strategyChoice)
+    {
+      choice.second->AddFace (face);
+    }
 }
 
 void
 ForwardingStrategy::RemoveFace (Ptr<Face> face)
 {
-  // do nothing here
+  BOOST_FOREACH (const StrategyChoice::value_type &choice, m_strategyChoice)
+    {
+      choice.second->RemoveFace (face);
+    }
 }
 
 void
-ForwardingStrategy::DidAddFibEntry (Ptr<fib::Entry> fibEntry)
+ForwardingStrategy::SetStrategyChoice (const Name &prefix, Ptr<ForwardingStrategy> strategy)
 {
-  // do nothing here
+  NS_LOG_FUNCTION (this << prefix << strategy);
+  NS_ASSERT (strategy != 0 && strategy != this);
+
+  strategy->m_pit = m_pit;
+  strategy->m_fib = m_fib;
+  strategy->m_contentStore = m_contentStore;
+
+  strategy->TraceConnectWithoutContext ("OutInterests",
+                                        MakeBoundCallback (&RelayTrace2<Ptr<const Interest>, Ptr<const Face> >, &m_outInterests));
+  strategy->TraceConnectWithoutContext ("InInterests",
+                                        MakeBoundCallback (&RelayTrace2<Ptr<const Interest>, Ptr<const Face> >, &m_inInterests));
+  strategy->TraceConnectWithoutContext ("DropInterests",
+                                        MakeBoundCallback (&RelayTrace2<Ptr<const Interest>, Ptr<const Face> >, &m_dropInterests));
+
+  strategy->TraceConnectWithoutContext ("OutData",
+                                        MakeBoundCallback (&RelayTrace4<Ptr<const ContentObject>, Ptr<const Packet>, bool, Ptr<const Face> >,
+                                                           &m_outData));
+  strategy->TraceConnectWithoutContext ("InData",
+                                        MakeBoundCallback (&RelayTrace3<Ptr<const ContentObject>, Ptr<const Packet>, Ptr<const Face> >,
+                                                           &m_inData));
+  strategy->TraceConnectWithoutContext ("DropData",
+                                        MakeBoundCallback (&RelayTrace3<Ptr<const ContentObject>, Ptr<const Packet>, Ptr<const Face> >,
+                                                           &m_dropData));
+
+  strategy->TraceConnectWithoutContext ("SatisfiedInterests",
+                                        MakeBoundCallback (&RelayTrace1<Ptr<const pit::Entry> >, &m_satisfiedInterests));
+  strategy->TraceConnectWithoutContext ("TimedOutInterests",
+                                        MakeBoundCallback (&RelayTrace1<Ptr<const pit::Entry> >, &m_timedOutInterests));
+
+  m_strategyChoice[prefix] = strategy;
+
+  // responsible strategies of existing FIB entries need to be resolved again
+  if (m_fib != 0)
+    {
+      for (Ptr<fib::Entry> entry = m_fib->Begin (); entry != m_fib->End (); entry = m_fib->Next (entry))
+        {
+          entry->m_strategy = 0;
+        }
+    }
 }
 
-void
-ForwardingStrategy::WillRemoveFibEntry (Ptr<fib::Entry> fibEntry)
+ForwardingStrategy *
+ForwardingStrategy::FindStrategy (Ptr<fib::Entry> fibEntry)
 {
-  // do nothing here
+  if (m_strategyChoice.empty () || fibEntry == 0)
+    return this;
+
+  if (fibEntry->m_strategy != 0)
+    return fibEntry->m_strategy;
+
+  ForwardingStrategy *strategy = this;
+  Name prefix = fibEntry->GetPrefix ();
+  while (true)
+    {
+      StrategyChoice::iterator choice = m_strategyChoice.find (prefix);
+      if (choice != m_strategyChoice.end ())
+        {
+          strategy = PeekPointer (choice->second);
+          break;
+        }
+
+      if (prefix.size () == 0)
+        break;
+      prefix = prefix.cut (1);
+    }
+
+  NS_LOG_DEBUG ("Strategy for " << fibEntry->GetPrefix () << " is " << strategy->GetInstanceTypeId ().GetName ());
+  fibEntry->m_strategy = strategy;
+  return strategy;
 }
 
 
@@ -25,6 +25,10 @@
 #include "ns3/callback.h"
 #include "ns3/object.h"
 #include "ns3/traced-callback.h"
+#include "ns3/ndn-name.h"
+
+#include <map>
+#include <vector>
 
 namespace ns3 {
 namespace ndn {
@@ -68,7 +72,10 @@ public:
   /**
    * \brief Actual processing of incoming Ndn interests. Note, interests do not have payload
    *
-   * Processing Interest packets
+   * Processing Interest packets.  Called on the main strategy of the node, which looks up (or creates)
+   * the PIT entry and passes the Interest to the strategy responsible for the FIB entry of the PIT entry
+   * (see SetStrategyChoice and HandleInterest)
+   *
    * @param face    incoming face
    * @param header  deserialized Interest header
    * @param origPacket  original packet
@@ -81,7 +88,10 @@ public:
   /**
    * \brief Actual processing of incoming Ndn content objects
    *
-   * Processing ContentObject packets
+   * Processing ContentObject packets.  Called on the main strategy of the node, which looks up all
+   * PIT entries that can be satisfied by the Data, adds the Data to the content store, and passes each group
+   * of PIT entries to the strategy responsible for them (see SetStrategyChoice and HandleData)
+   *
    * @param face    incoming face
    * @param header  deserialized ContentObject header
    * @param payload data packet payload
@@ -121,14 +131,39 @@ public:
    * @param fibEntry FIB entry that was added
    */
   virtual void
-  DidAddFibEntry (Ptr<fib::Entry> fibEntry);
+  DidAddFibEntry (Ptr<fib::Entry> fibEntry)
+  { }
 
   /**
    * @brief Fired just before FIB entry will be removed from FIB
    * @param fibEntry FIB entry that will be removed
    */
   virtual void
-  WillRemoveFibEntry (Ptr<fib::Entry> fibEntry);
+  WillRemoveFibEntry (Ptr<fib::Entry> fibEntry)
+  { }
+
+  /**
+   * @brief Assign a different forwarding strategy to a namespace
+   *
+   * Interests and Data that match FIB entries under `prefix` (longest prefix wins)
+   * will be processed by `strategy`, all other packets by this strategy.  The strategy
+   * shares PIT, FIB, and content store with this strategy, and its base traces (Out/In/DropInterests,
+   * Out/In/DropData, SatisfiedInterests, TimedOutInterests) are relayed to traces of this strategy.
+   *
+   * Responsible strategy is resolved once per FIB entry and cached inside the entry.  Strategy choices
+   * should be configured before faces and routes are added (StackHelper::AddStrategyChoice does that).
+   *
+   * @param prefix   namespace
+   * @param strategy strategy for the namespace (should not be aggregated to any node)
+   */
+  void
+  SetStrategyChoice (const Name &prefix, Ptr<ForwardingStrategy> strategy);
+
+  /**
+   * @brief Get strategy responsible for the FIB entry (this strategy, if no choice has been configured)
+   */
+  ForwardingStrategy *
+  FindStrategy (Ptr<fib::Entry> fibEntry);
 
 protected:
   /**
@@ -151,7 +186,8 @@ protected:
   DidCreatePitEntry (Ptr<Face> inFace,
                      Ptr<const Interest> header,
                      Ptr<const Packet> origPacket,
-                     Ptr<pit::Entry> pitEntry);
+                     Ptr<pit::Entry> pitEntry)
+  { }
 
   /**
    * @brief An event that is fired every time a new PIT entry cannot be created (e.g., PIT container imposes a limit)
@@ -202,7 +238,8 @@ protected:
   DidSuppressSimilarInterest (Ptr<Face> inFace,
                               Ptr<const Interest> header,
                               Ptr<const Packet> origPacket,
-                              Ptr<pit::Entry> pitEntry);
+                              Ptr<pit::Entry> pitEntry)
+  { }
 
   /**
    * @brief An event that is fired every time when a similar Interest is received and further forwarded (not suppressed/collapsed)
@@ -220,7 +257,8 @@ protected:
   DidForwardSimilarInterest (Ptr<Face> inFace,
                              Ptr<const Interest> header,
                              Ptr<const Packet> origPacket,
-                             Ptr<pit::Entry> pitEntry);
+                             Ptr<pit::Entry> pitEntry)
+  { }
 
   /**
    * @brief An even that is fired when Interest cannot be forwarded
@@ -323,7 +361,8 @@ protected:
                            Ptr<const ContentObject> header,
                            Ptr<const Packet> payload,
                            Ptr<const Packet> origPacket,
-                           bool didCreateCacheEntry);
+                           bool didCreateCacheEntry)
+  { }
 
   /**
    * @brief Event which is fired every time an unsolicited DATA packet (no active PIT entry) is received
@@ -342,7 +381,8 @@ protected:
                              Ptr<const ContentObject> header,
                              Ptr<const Packet> payload,
                              Ptr<const Packet> origPacket,
-                             bool didCreateCacheEntry);
+                             bool didCreateCacheEntry)
+  { }
 
   /**
    * @brief Method implementing logic to suppress (collapse) similar Interests
@@ -428,6 +468,10 @@ protected:
    * General tasks so far are adding face to the list of incoming face, updating
    * PIT entry lifetime, calling DoPropagateInterest, and retransmissions (enabled by default).
    *
+   * The first outgoing face chosen by DoPropagateInterest gets a copy of the original packet.  If the Interest
+   * is sent on more than one face, a copy with updated hop count is made once (for the second face) and all
+   * other faces get copies of it, so hop count is not updated on every face.
+   *
    * @param inFace     incoming face
    * @param header     Interest header
    * @param origPacket original Interest packet
@@ -466,6 +510,93 @@ protected:
                        Ptr<const Packet> origPacket,
                        Ptr<pit::Entry> pitEntry) = 0;
 
+protected:
+  /**
+   * @brief Process Interest for which PIT entry has been already looked up or created by OnInterest
+   *
+   * @param inFace          incoming face
+   * @param header          deserialized Interest header
+   * @param origPacket      original packet
+   * @param pitEntry        PIT entry (0 if PIT entry could not be created)
+   * @param similarInterest true if PIT entry existed before the Interest has been received
+   */
+  virtual void
+  HandleInterest (Ptr<Face> inFace,
+                  Ptr<const Interest> header,
+                  Ptr<const Packet> origPacket,
+                  Ptr<pit::Entry> pitEntry,
+                  bool similarInterest);
+
+  /**
+   * @brief Process Data for the group of PIT entries this strategy is responsible for
+   *
+   * @param inFace              incoming face
+   * @param header              deserialized ContentObject header
+   * @param payload             data packet payload
+   * @param origPacket          original packet
+   * @param didCreateCacheEntry flag indicating whether a cache entry was added for this data packet or not
+   * @param pitEntries          PIT entries satisfied by the Data (empty, if Data is unsolicited)
+   */
+  virtual void
+  HandleData (Ptr<Face> inFace,
+              Ptr<const ContentObject> header,
+              Ptr<Packet> payload,
+              Ptr<const Packet> origPacket,
+              bool didCreateCacheEntry,
+              const std::vector< Ptr<pit::Entry> > &pitEntries);
+
+  /**
+   * @brief Processing pipeline of incoming Interests (actual implementation of HandleInterest)
+   *
+   * All events/actions of the pipeline are called through the hooks object.  ForwardingStrategy uses
+   * itself as the hooks object (i.e., virtual calls), while fw::Sealed uses an object that calls
+   * the events/actions of the specific strategy class directly, so they can be resolved and inlined
+   * at compile time.
+   *
+   * Definition is in ndn-forwarding-strategy-pipeline.h
+   */
+  template<class Hooks>
+  void
+  ProcessInterest (Hooks &hooks,
+                   Ptr<Face> inFace,
+                   Ptr<const Interest> header,
+                   Ptr<const Packet> origPacket,
+                   Ptr<pit::Entry> pitEntry,
+                   bool similarInterest);
+
+  /**
+   * @brief Processing pipeline of incoming Data (actual implementation of HandleData)
+   * @see ProcessInterest
+   */
+  template<class Hooks>
+  void
+  ProcessData (Hooks &hooks,
+               Ptr<Face> inFace,
+               Ptr<const ContentObject> header,
+               Ptr<Packet> payload,
+               Ptr<const Packet> origPacket,
+               bool didCreateCacheEntry,
+               const std::vector< Ptr<pit::Entry> > &pitEntries);
+
+  /**
+   * @brief Actual implementation of TrySendOutInterest
+   * @see ProcessInterest
+   */
+  template<class Hooks>
+  bool
+  ProcessSendOutInterest (Hooks &hooks,
+                          Ptr<Face> inFace,
+                          Ptr<Face> outFace,
+                          Ptr<const Interest> header,
+                          Ptr<const Packet> origPacket,
+                          Ptr<pit::Entry> pitEntry);
+
+  /**
+   * @brief Log suppression of the Interest (pipeline templates cannot use log component of ForwardingStrategy directly)
+   */
+  void
+  LogSuppressedInterest ();
+
 protected:
   // inherited from Object class
   virtual void NotifyNewAggregate (); ///< @brief Even when object is aggregated to another Object
@@ -509,6 +640,21 @@ protected:
 
   TracedCallback< Ptr<const pit::Entry> > m_satisfiedInterests;
   TracedCallback< Ptr<const pit::Entry> > m_timedOutInterests;
+
+private:
+  /**
+   * @brief State of Interest fan-out, valid only during PropagateInterest call
+   */
+  struct FanOut
+  {
+    Ptr<const Packet> m_origPacket; ///< @brief Interest packet passed to DoPropagateInterest
+    Ptr<Packet> m_packet;           ///< @brief copy of m_origPacket with updated hop count (made for the second outgoing face)
+    bool m_sent;                    ///< @brief true if Interest has been already sent on at least one face
+  };
+  FanOut *m_fanOut; ///< @brief fan-out of the current PropagateInterest call (0, if there is no such call)
+
+  typedef std::map<Name, Ptr<ForwardingStrategy> > StrategyChoice;
+  StrategyChoice m_strategyChoice; ///< @brief namespace-specific strategies (empty, if this strategy handles everything)
 };
 
 } // namespace ndn
@@ -0,0 +1,122 @@
+/* -*- Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2013 University of California, Los Angeles
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Alexander Afanasyev <alexander.afanasyev@ucla.edu>
+ */
+
+#include "sealed.h"
+#include "per-fib-limits.h"
+#include "per-out-face-limits.h"
+
+#include "ns3/ndn-l3-protocol.h"
+#include "ns3/ndn-interest.h"
+#include "ns3/ndn-content-object.h"
+
+#include "best-route.h"
+#include "flooding.h"
+#include "smart-flooding.h"
+
+namespace ns3 {
+namespace ndn {
+namespace fw {
+
+template class Sealed<BestRoute>;
+typedef Sealed<BestRoute> SealedBestRoute;
+NS_OBJECT_ENSURE_REGISTERED (SealedBestRoute);
+
+template class Sealed<Flooding>;
+typedef Sealed<Flooding> SealedFlooding;
+NS_OBJECT_ENSURE_REGISTERED (SealedFlooding);
+
+template class Sealed<SmartFlooding>;
+typedef Sealed<SmartFlooding> SealedSmartFlooding;
+NS_OBJECT_ENSURE_REGISTERED (SealedSmartFlooding);
+
+template class Sealed< PerOutFaceLimits<BestRoute> >;
+typedef Sealed< PerOutFaceLimits<BestRoute> > SealedPerOutFaceLimitsBestRoute;
+NS_OBJECT_ENSURE_REGISTERED (SealedPerOutFaceLimitsBestRoute);
+
+template class Sealed< PerOutFaceLimits<Flooding> >;
+typedef Sealed< PerOutFaceLimits<Flooding> > SealedPerOutFaceLimitsFlooding;
+NS_OBJECT_ENSURE_REGISTERED (SealedPerOutFaceLimitsFlooding);
+
+template class Sealed< PerOutFaceLimits<SmartFlooding> >;
+typedef Sealed< PerOutFaceLimits<SmartFlooding> > SealedPerOutFaceLimitsSmartFlooding;
+NS_OBJECT_ENSURE_REGISTERED (SealedPerOutFaceLimitsSmartFlooding);
+
+template class Sealed< PerFibLimits< PerOutFaceLimits<BestRoute> > >;
+typedef Sealed< PerFibLimits< PerOutFaceLimits<BestRoute> > > SealedPerFibLimitsPerOutFaceLimitsBestRoute;
+NS_OBJECT_ENSURE_REGISTERED (SealedPerFibLimitsPerOutFaceLimitsBestRoute);
+
+template class Sealed< PerFibLimits< PerOutFaceLimits<Flooding> > >;
+typedef Sealed< PerFibLimits< PerOutFaceLimits<Flooding> > > SealedPerFibLimitsPerOutFaceLimitsFlooding;
+NS_OBJECT_ENSURE_REGISTERED (SealedPerFibLimitsPerOutFaceLimitsFlooding);
+
+template class Sealed< PerFibLimits< PerOutFaceLimits<SmartFlooding> > >;
+typedef Sealed< PerFibLimits< PerOutFaceLimits<SmartFlooding> > > SealedPerFibLimitsPerOutFaceLimitsSmartFlooding;
+NS_OBJECT_ENSURE_REGISTERED (SealedPerFibLimitsPerOutFaceLimitsSmartFlooding);
+
+#ifdef DOXYGEN
+/**
+ * \brief BestRoute strategy with compile-time bound events/actions
+ */
+class BestRoute::Sealed : public ::ns3::ndn::fw::Sealed<BestRoute> { };
+
+/**
+ * \brief Flooding strategy with compile-time bound events/actions
+ */
+class Flooding::Sealed : public ::ns3::ndn::fw::Sealed<Flooding> { };
+
+/**
+ * \brief SmartFlooding strategy with compile-time bound events/actions
+ */
+class SmartFlooding::Sealed : public ::ns3::ndn::fw::Sealed<SmartFlooding> { };
+
+/**
+ * \brief BestRoute strategy with per-out-face limits and compile-time bound events/actions
+ */
+class BestRoute::PerOutFaceLimits::Sealed : public ::ns3::ndn::fw::Sealed< ::ns3::ndn::fw::PerOutFaceLimits<BestRoute> > { };
+
+/**
+ * \brief Flooding strategy with per-out-face limits and compile-time bound events/actions
+ */
+class Flooding::PerOutFaceLimits::Sealed : public ::ns3::ndn::fw::Sealed< ::ns3::ndn::fw::PerOutFaceLimits<Flooding> > { };
+
+/**
+ * \brief SmartFlooding strategy with per-out-face limits and compile-time bound events/actions
+ */
+class SmartFlooding::PerOutFaceLimits::Sealed : public ::ns3::ndn::fw::Sealed< ::ns3::ndn::fw::PerOutFaceLimits<SmartFlooding> > { };
+
+/**
+ * \brief BestRoute strategy with per-fib-per-out-face limits and compile-time bound events/actions
+ */
+class BestRoute::PerOutFaceLimits::PerFibLimits::Sealed : public ::ns3::ndn::fw::Sealed< ::ns3::ndn::fw::PerFibLimits< ::ns3::ndn::fw::PerOutFaceLimits<BestRoute> > > { };
+
+/**
+ * \brief Flooding strategy with per-fib-per-out-face limits and compile-time bound events/actions
+ */
+class Flooding::PerOutFaceLimits::PerFibLimits::Sealed : public ::ns3::ndn::fw::Sealed< ::ns3::ndn::fw::PerFibLimits< ::ns3::ndn::fw::PerOutFaceLimits<Flooding> > > { };
+
+/**
+ * \brief SmartFlooding strategy with per-fib-per-out-face limits and compile-time bound events/actions
+ */
+class SmartFlooding::PerOutFaceLimits::PerFibLimits::Sealed : public ::ns3::ndn::fw::Sealed< ::ns3::ndn::fw::PerFibLimits< ::ns3::ndn::fw::PerOutFaceLimits<SmartFlooding> > > { };
+#endif
+
+} // namespace fw
+} // namespace ndn
+} // namespace ns3
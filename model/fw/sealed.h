@@ -0,0 +1,229 @@
+/* -*- Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2013 University of California, Los Angeles
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Alexander Afanasyev <alexander.afanasyev@ucla.edu>
+ */
+
+#ifndef NDNSIM_SEALED_H
+#define NDNSIM_SEALED_H
+
+#include "ns3/ndn-forwarding-strategy.h"
+#include "ndn-forwarding-strategy-pipeline.h"
+
+namespace ns3 {
+namespace ndn {
+namespace fw {
+
+/**
+ * \ingroup ndn
+ * \brief Final layer of the strategy composition, binding events/actions of the strategy at compile time
+ *
+ * Strategies composed of template layers (e.g., PerOutFaceLimits<BestRoute>) call the parent
+ * implementations directly, but the generic processing pipeline of ForwardingStrategy calls every event/action
+ * (DidCreatePitEntry, ShouldSuppressIncomingInterest, CanSendOutInterest, DidSendOutInterest, etc.) virtually.
+ * Sealed instantiates the same pipeline (ForwardingStrategy::ProcessInterest, ProcessData, and ProcessSendOutInterest)
+ * with the hooks object that calls events/actions of Parent class explicitly, so the whole composition
+ * is resolved at compile time.  Events/actions of the template layers (e.g., limits checks of PerOutFaceLimits)
+ * and no-op events of ForwardingStrategy are defined in headers and can be inlined into the pipeline,
+ * while events/actions defined in .cc files (e.g., of BestRoute or Nacks) are called directly, but not inlined.
+ *
+ * Sealed must be the last layer of the composition (no further overrides of events/actions are visible
+ * to the pipeline), and Parent should not override HandleInterest, HandleData, and TrySendOutInterest.
+ */
+template<class Parent>
+class Sealed :
+    public Parent
+{
+private:
+  typedef Parent super;
+
+public:
+  /**
+   * @brief Get TypeId of the class
+   */
+  static TypeId
+  GetTypeId ();
+
+  /**
+   * @brief Helper function to retrieve logging name for the forwarding strategy
+   */
+  static std::string
+  GetLogName ();
+
+  /**
+   * @brief Default constructor
+   */
+  Sealed ()
+  { }
+
+protected:
+  /// \copydoc ForwardingStrategy::HandleInterest
+  virtual void
+  HandleInterest (Ptr<Face> inFace,
+                  Ptr<const Interest> header,
+                  Ptr<const Packet> origPacket,
+                  Ptr<pit::Entry> pitEntry,
+                  bool similarInterest)
+  {
+    StaticHooks hooks (this);
+    this->ProcessInterest (hooks, inFace, header, origPacket, pitEntry, similarInterest);
+  }
+
+  /// \copydoc ForwardingStrategy::HandleData
+  virtual void
+  HandleData (Ptr<Face> inFace,
+              Ptr<const ContentObject> header,
+              Ptr<Packet> payload,
+              Ptr<const Packet> origPacket,
+              bool didCreateCacheEntry,
+              const std::vector< Ptr<pit::Entry> > &pitEntries)
+  {
+    StaticHooks hooks (this);
+    this->ProcessData (hooks, inFace, header, payload, origPacket, didCreateCacheEntry, pitEntries);
+  }
+
+  /// \copydoc ForwardingStrategy::TrySendOutInterest
+  virtual bool
+  TrySendOutInterest (Ptr<Face> inFace,
+                      Ptr<Face> outFace,
+                      Ptr<const Interest> header,
+                      Ptr<const Packet> origPacket,
+                      Ptr<pit::Entry> pitEntry)
+  {
+    StaticHooks hooks (this);
+    return this->ProcessSendOutInterest (hooks, inFace, outFace, header, origPacket, pitEntry);
+  }
+
+private:
+  /**
+   * @brief Hooks object for the ForwardingStrategy pipeline, calling Parent's events/actions explicitly
+   */
+  class StaticHooks
+  {
+  public:
+    StaticHooks (Sealed *self)
+      : m_self (self)
+    {
+    }
+
+    void
+    DidCreatePitEntry (Ptr<Face> inFace, Ptr<const Interest> header, Ptr<const Packet> origPacket, Ptr<pit::Entry> pitEntry)
+    {
+      m_self->super::DidCreatePitEntry (inFace, header, origPacket, pitEntry);
+    }
+
+    void
+    FailedToCreatePitEntry (Ptr<Face> inFace, Ptr<const Interest> header, Ptr<const Packet> origPacket)
+    {
+      m_self->super::FailedToCreatePitEntry (inFace, header, origPacket);
+    }
+
+    void
+    DidReceiveDuplicateInterest (Ptr<Face> inFace, Ptr<const Interest> header, Ptr<const Packet> origPacket, Ptr<pit::Entry> pitEntry)
+    {
+      m_self->super::DidReceiveDuplicateInterest (inFace, header, origPacket, pitEntry);
+    }
+
+    bool
+    ShouldSuppressIncomingInterest (Ptr<Face> inFace, Ptr<const Interest> header, Ptr<const Packet> origPacket, Ptr<pit::Entry> pitEntry)
+    {
+      return m_self->super::ShouldSuppressIncomingInterest (inFace, header, origPacket, pitEntry);
+    }
+
+    void
+    DidSuppressSimilarInterest (Ptr<Face> inFace, Ptr<const Interest> header, Ptr<const Packet> origPacket, Ptr<pit::Entry> pitEntry)
+    {
+      m_self->super::DidSuppressSimilarInterest (inFace, header, origPacket, pitEntry);
+    }
+
+    void
+    DidForwardSimilarInterest (Ptr<Face> inFace, Ptr<const Interest> header, Ptr<const Packet> origPacket, Ptr<pit::Entry> pitEntry)
+    {
+      m_self->super::DidForwardSimilarInterest (inFace, header, origPacket, pitEntry);
+    }
+
+    void
+    PropagateInterest (Ptr<Face> inFace, Ptr<const Interest> header, Ptr<const Packet> origPacket, Ptr<pit::Entry> pitEntry)
+    {
+      m_self->super::PropagateInterest (inFace, header, origPacket, pitEntry);
+    }
+
+    bool
+    CanSendOutInterest (Ptr<Face> inFace, Ptr<Face> outFace, Ptr<const Interest> header, Ptr<const Packet> origPacket, Ptr<pit::Entry> pitEntry)
+    {
+      return m_self->super::CanSendOutInterest (inFace, outFace, header, origPacket, pitEntry);
+    }
+
+    void
+    DidSendOutInterest (Ptr<Face> inFace, Ptr<Face> outFace, Ptr<const Interest> header, Ptr<const Packet> origPacket, Ptr<pit::Entry> pitEntry)
+    {
+      m_self->super::DidSendOutInterest (inFace, outFace, header, origPacket, pitEntry);
+    }
+
+    void
+    DidReceiveSolicitedData (Ptr<Face> inFace, Ptr<const ContentObject> header, Ptr<const Packet> payload, Ptr<const Packet> origPacket, bool didCreateCacheEntry)
+    {
+      m_self->super::DidReceiveSolicitedData (inFace, header, payload, origPacket, didCreateCacheEntry);
+    }
+
+    void
+    DidReceiveUnsolicitedData (Ptr<Face> inFace, Ptr<const ContentObject> header, Ptr<const Packet> payload, Ptr<const Packet> origPacket, bool didCreateCacheEntry)
+    {
+      m_self->super::DidReceiveUnsolicitedData (inFace, header, payload, origPacket, didCreateCacheEntry);
+    }
+
+    void
+    WillSatisfyPendingInterest (Ptr<Face> inFace, Ptr<pit::Entry> pitEntry)
+    {
+      m_self->super::WillSatisfyPendingInterest (inFace, pitEntry);
+    }
+
+    void
+    SatisfyPendingInterest (Ptr<Face> inFace, Ptr<const ContentObject> header, Ptr<const Packet> payload, Ptr<const Packet> origPacket, Ptr<pit::Entry> pitEntry)
+    {
+      m_self->super::SatisfyPendingInterest (inFace, header, payload, origPacket, pitEntry);
+    }
+
+  private:
+    Sealed *m_self;
+  };
+};
+
+template<class Parent>
+std::string
+Sealed<Parent>::GetLogName ()
+{
+  return super::GetLogName ()+".Sealed";
+}
+
+template<class Parent>
+TypeId
+Sealed<Parent>::GetTypeId (void)
+{
+  static TypeId tid = TypeId ((super::GetTypeId ().GetName ()+"::Sealed").c_str ())
+    .SetGroupName ("Ndn")
+    .template SetParent <super> ()
+    .template AddConstructor <Sealed> ()
+    ;
+  return tid;
+}
+
+} // namespace fw
+} // namespace ndn
+} // namespace ns3
+
+#endif // NDNSIM_SEALED_H
@@ -111,8 +111,20 @@ Face::RegisterProtocolHandler (ProtocolHandler handler)
   m_protocolHandler = handler;
 }
 
+void
+Face::IncrementHopCount (Ptr<Packet> packet)
+{
+  FwHopCountTag hopCount;
+  bool tagExists = packet->RemovePacketTag (hopCount);
+  if (tagExists)
+    {
+      hopCount.Increment ();
+      packet->AddPacketTag (hopCount);
+    }
+}
+
 bool
-Face::Send (Ptr<Packet> packet)
+Face::Send (Ptr<Packet> packet, bool incrementHopCount/* = true*/)
 {
   NS_LOG_FUNCTION (boost::cref (*this) << packet << packet->GetSize ());
   NS_LOG_DEBUG (*packet);
@@ -123,12 +135,9 @@ Face::Send (Ptr<Packet> packet)
       return false;
     }
 
-  FwHopCountTag hopCount;
-  bool tagExists = packet->RemovePacketTag (hopCount);
-  if (tagExists)
+  if (incrementHopCount)
     {
-      hopCount.Increment ();
-      packet->AddPacketTag (hopCount);
+      IncrementHopCount (packet);
     }
 
   bool ok = SendImpl (packet);
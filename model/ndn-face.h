@@ -95,11 +95,22 @@ public:
    * This method will be called by lower layers to send data to device or application
    *
    * \param p smart pointer to a packet to send
+   * \param incrementHopCount if false, hop count of the packet (FwHopCountTag) is not updated
+   *                          (e.g., it was already updated with IncrementHopCount)
    *
    * @return false if either limit is reached
    */
   bool
-  Send (Ptr<Packet> p);
+  Send (Ptr<Packet> p, bool incrementHopCount = true);
+
+  /**
+   * \brief Increment hop count of the packet (FwHopCountTag), if packet has it
+   *
+   * When the same packet is sent on several faces, hop count can be updated once and
+   * copies of the updated packet (sharing buffer and tag list) sent with Send (copy, false)
+   */
+  static void
+  IncrementHopCount (Ptr<Packet> p);
 
   /**
    * \brief Receive packet from application or another node and forward it to the Ndn stack
@@ -97,6 +97,12 @@ GlobalRouter::GetLocalPrefixes () const
   return m_localPrefixes;
 }
 
+GlobalRouter::InstalledRoutes &
+GlobalRouter::GetInstalledRoutes ()
+{
+  return m_installedRoutes;
+}
+
 // void
 // GlobalRouter::AddIncidencyChannel (Ptr< NdnFace > face, Ptr< Channel > channel)
 // {
@@ -23,8 +23,11 @@
 
 #include "ns3/object.h"
 #include "ns3/ptr.h"
+#include "ns3/ndn-name.h"
 
 #include <list>
+#include <map>
+#include <set>
 #include <boost/tuple/tuple.hpp>
 
 namespace ns3 {
@@ -57,6 +60,10 @@ public:
    * @brief List of locally exported prefixes
    */
   typedef std::list< Ptr<Name> > LocalPrefixList;
+  /**
+   * @brief Next hops installed in FIB by GlobalRoutingHelper (prefix -> faces)
+   */
+  typedef std::map< Name, std::set< Ptr<Face> > > InstalledRoutes;
   
   /**
    * \brief Interface ID
@@ -110,6 +117,15 @@ public:
   const LocalPrefixList &
   GetLocalPrefixes () const;
 
+  /**
+   * @brief Get next hops that GlobalRoutingHelper has installed in FIB of the node
+   *
+   * Only these next hops are invalidated or removed when routes are recalculated, so FIB records added
+   * by applications or manually are never touched by the helper
+   */
+  InstalledRoutes &
+  GetInstalledRoutes ();
+
   // ??
 protected:
   virtual void
@@ -121,6 +137,7 @@ private:
   Ptr<L3Protocol> m_ndn;
   LocalPrefixList m_localPrefixes;
   IncidencyList m_incidencies;
+  InstalledRoutes m_installedRoutes;
 
   static uint32_t m_idCounter;
 };
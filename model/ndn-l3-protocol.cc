@@ -175,31 +175,42 @@ L3Protocol::RemoveFace (Ptr<Face> face)
   // ask face to register in lower-layer stack
   face->RegisterProtocolHandler (MakeNullCallback<void,const Ptr<Face>&,const Ptr<const Packet>&> ());
   Ptr<Pit> pit = GetObject<Pit> ();
+  Ptr<Fib> fib = GetObject<Fib> ();
 
-  // just to be on a safe side. Do the process in two steps
-  std::list< Ptr<pit::Entry> > entriesToRemoves;
-  for (Ptr<pit::Entry> pitEntry = pit->Begin (); pitEntry != 0; pitEntry = pit->Next (pitEntry))
+  // only PIT entries that reference the face are touched (using PIT per-face index)
+  std::vector< Ptr<pit::Entry> > pitEntries;
+  pit->FindEntriesWithFace (face, pitEntries);
+  BOOST_FOREACH (Ptr<pit::Entry> pitEntry, pitEntries)
     {
       pitEntry->RemoveAllReferencesToFace (face);
+    }
+
+  // If this face is the only for the associated FIB entry, then FIB entry will be removed soon.
+  // Thus, we have to remove all PIT entries that were created for this FIB entry
+  std::vector< Ptr<fib::Entry> > fibEntries;
+  fib->FindEntriesWithFace (face, fibEntries);
 
-      // If this face is the only for the associated FIB entry, then FIB entry will be removed soon.
-      // Thus, we have to remove the whole PIT entry
-      if (pitEntry->GetFibEntry ()->m_faces.size () == 1 &&
-          pitEntry->GetFibEntry ()->m_faces.begin ()->GetFace () == face)
+  // just to be on a safe side. Do the process in two steps
+  std::vector< Ptr<pit::Entry> > entriesToRemove;
+  BOOST_FOREACH (Ptr<fib::Entry> fibEntry, fibEntries)
+    {
+      if (fibEntry->m_faces.size () == 1)
         {
-          entriesToRemoves.push_back (pitEntry);
+          pit->FindEntriesWithFibEntry (fibEntry, entriesToRemove);
         }
     }
-  BOOST_FOREACH (Ptr<pit::Entry> removedEntry, entriesToRemoves)
+  BOOST_FOREACH (Ptr<pit::Entry> removedEntry, entriesToRemove)
     {
-      pit->MarkErased (removedEntry);
+      // skip entries that are no longer in PIT
+      if (pit->Find (removedEntry->GetPrefix ()) == removedEntry)
+        pit->MarkErased (removedEntry);
     }
 
   FaceList::iterator face_it = find (m_faces.begin(), m_faces.end(), face);
   NS_ASSERT_MSG (face_it != m_faces.end (), "Attempt to remove face that doesn't exist");
   m_faces.erase (face_it);
 
-  GetObject<Fib> ()->RemoveFromAll (face);
+  fib->RemoveFromAll (face);
   m_forwardingStrategy->RemoveFace (face); // notify that face is removed
 }
 
@@ -33,6 +33,11 @@
 #include "ns3/ndn-interest.h"
 #include "ns3/simulator.h"
 
+#include <algorithm>
+#include <set>
+#include <vector>
+#include <boost/functional/hash.hpp>
+
 NS_LOG_COMPONENT_DEFINE ("ndn.ShaperNetDeviceFace");
 
 namespace ns3 {
@@ -87,6 +92,128 @@ private:
 };
 
 
+static const double PIE_UPDATE_INTERVAL = 0.03; // seconds
+static const uint32_t FLOW_QUEUE_MIN_CAPACITY = 8; // initial capacity of FQ-CoDel flow queues
+
+/**
+ * @brief Timer of PIE updates, shared by all shaper faces of the node (aggregated to the node)
+ *
+ * Ticks are at multiples of PIE_UPDATE_INTERVAL.  On each tick, all registered faces are updated, faces
+ * with empty queues leave the timer, and the timer stops when no faces are left.  The timer is
+ * cancelled when the node is disposed (e.g., on Simulator::Destroy).
+ */
+class ShaperPieTimer : public Object
+{
+public:
+  static TypeId GetTypeId ()
+  {
+    static TypeId tid = TypeId ("ns3::ndn::ShaperPieTimer")
+      .SetParent<Object> ()
+      .SetGroupName ("Ndn")
+      .AddConstructor<ShaperPieTimer> ()
+      ;
+    return tid;
+  }
+
+  ShaperPieTimer ()
+    : m_nextTick (0)
+  {
+  }
+
+  /**
+   * @brief Index of the next tick of the timer
+   */
+  int64_t
+  NextTick () const
+  {
+    if (m_event.IsRunning ())
+      return m_nextTick;
+
+    return Simulator::Now ().GetTimeStep () / Seconds (PIE_UPDATE_INTERVAL).GetTimeStep () + 1;
+  }
+
+  /**
+   * @brief Register face in the timer (timer is started if necessary)
+   */
+  void
+  Add (ShaperNetDeviceFace *face)
+  {
+    m_faces.insert (face);
+
+    if (!m_event.IsRunning ())
+      {
+        m_nextTick = NextTick ();
+        Schedule ();
+      }
+  }
+
+  /**
+   * @brief Unregister face from the timer (timer is stopped if no faces are left)
+   */
+  void
+  Remove (ShaperNetDeviceFace *face)
+  {
+    m_faces.erase (face);
+    if (m_faces.empty ())
+      m_event.Cancel ();
+  }
+
+protected:
+  virtual void
+  DoDispose ()
+  {
+    m_event.Cancel ();
+    for (std::set<ShaperNetDeviceFace*>::iterator face = m_faces.begin (); face != m_faces.end (); face++)
+      {
+        (*face)->m_pie_active = false;
+      }
+    m_faces.clear ();
+
+    Object::DoDispose ();
+  }
+
+private:
+  void
+  Schedule ()
+  {
+    m_event = Simulator::ScheduleWithContext (GetObject<Node> ()->GetId (),
+                                              Time (Seconds (PIE_UPDATE_INTERVAL).GetTimeStep () * m_nextTick) - Simulator::Now (),
+                                              &ShaperPieTimer::Tick, this);
+  }
+
+  void
+  Tick ()
+  {
+    m_nextTick ++;
+
+    std::vector<ShaperNetDeviceFace*> idleFaces;
+    for (std::set<ShaperNetDeviceFace*>::iterator face = m_faces.begin (); face != m_faces.end (); face++)
+      {
+        (*face)->PIEUpdate ();
+        (*face)->m_pie_next_tick = m_nextTick;
+
+        if ((*face)->m_interestQueue.empty ())
+          idleFaces.push_back (*face);
+      }
+
+    // idle faces leave the timer, missed updates will be calculated in PIEResume
+    for (std::vector<ShaperNetDeviceFace*>::iterator face = idleFaces.begin (); face != idleFaces.end (); face++)
+      {
+        (*face)->m_pie_active = false;
+        m_faces.erase (*face);
+      }
+
+    if (!m_faces.empty ())
+      Schedule ();
+  }
+
+private:
+  std::set<ShaperNetDeviceFace*> m_faces; // faces registered in the timer
+  EventId m_event;
+  int64_t m_nextTick; // index of the next tick
+};
+
+NS_OBJECT_ENSURE_REGISTERED (ShaperPieTimer);
 NS_OBJECT_ENSURE_REGISTERED (ShaperNetDeviceFace);
 
 TypeId
@@ -116,7 +243,8 @@ ShaperNetDeviceFace::GetTypeId ()
                    MakeEnumAccessor (&ShaperNetDeviceFace::SetMode),
                    MakeEnumChecker (QUEUE_MODE_DROPTAIL, "QUEUE_MODE_DROPTAIL",
                                     QUEUE_MODE_PIE, "QUEUE_MODE_PIE",
-                                    QUEUE_MODE_CODEL, "QUEUE_MODE_CODEL"))
+                                    QUEUE_MODE_CODEL, "QUEUE_MODE_CODEL",
+                                    QUEUE_MODE_FQ_CODEL, "QUEUE_MODE_FQ_CODEL"))
     .AddAttribute ("DelayTarget",
                    "Target queueing delay (for PIE or CoDel).",
                    TimeValue (Seconds(0.02)),
@@ -132,6 +260,21 @@ ShaperNetDeviceFace::GetTypeId ()
                    TimeValue (Seconds(0.1)),
                    MakeTimeAccessor (&ShaperNetDeviceFace::m_delayObserveInterval),
                    MakeTimeChecker ())
+    .AddAttribute ("Flows",
+                   "Number of per-flow queues (for FQ-CoDel).",
+                   UintegerValue (32),
+                   MakeUintegerAccessor (&ShaperNetDeviceFace::m_flowCount),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("Quantum",
+                   "Number of bytes each flow can send in a round of deficit round robin (for FQ-CoDel).",
+                   UintegerValue (100),
+                   MakeUintegerAccessor (&ShaperNetDeviceFace::m_quantum),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("FlowPrefixLength",
+                   "Number of Interest name components that identify a flow, 0 means all but the last component (for FQ-CoDel).",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&ShaperNetDeviceFace::m_flowPrefixLength),
+                   MakeUintegerChecker<uint32_t> ())
     ;
   return tid;
 }
@@ -156,10 +299,9 @@ ShaperNetDeviceFace::ShaperNetDeviceFace (Ptr<Node> node, const Ptr<NetDevice> &
   , m_avg_dq_rate (0.0)
   , m_dq_start (0.0)
   , m_burst_allowance (Seconds(0.1))
-  , m_first_above_time (0.0)
-  , m_drop_next (0.0)
-  , m_drop_count (0)
-  , m_dropping (false)
+  , m_pie_next_tick (0)
+  , m_pie_active (false)
+  , m_flowBacklog (0)
 {
   DataRateValue dataRate;
   netDevice->GetAttribute ("DataRate", dataRate);
@@ -170,6 +312,9 @@ ShaperNetDeviceFace::ShaperNetDeviceFace (Ptr<Node> node, const Ptr<NetDevice> &
 ShaperNetDeviceFace::~ShaperNetDeviceFace ()
 {
   NS_LOG_FUNCTION_NOARGS ();
+
+  if (m_pie_active)
+    m_pieTimer->Remove (this);
 }
 
 ShaperNetDeviceFace& ShaperNetDeviceFace::operator= (const ShaperNetDeviceFace &)
@@ -189,8 +334,24 @@ ShaperNetDeviceFace::SetMode (ShaperNetDeviceFace::QueueMode mode)
 {
   NS_LOG_FUNCTION (this << mode);
   m_mode = mode;
-  if (m_mode == QUEUE_MODE_PIE)
-    Simulator::Schedule (Seconds(0.03), &ShaperNetDeviceFace::PIEUpdate, this);
+  if (m_mode == QUEUE_MODE_PIE && !m_pie_active)
+    m_pie_next_tick = GetPieTimer ()->NextTick (); // PIE updates are applied when the first Interest is enqueued
+}
+
+Ptr<ShaperPieTimer>
+ShaperNetDeviceFace::GetPieTimer ()
+{
+  if (m_pieTimer == 0)
+    {
+      Ptr<Node> node = GetNode ();
+      m_pieTimer = node->GetObject<ShaperPieTimer> ();
+      if (m_pieTimer == 0)
+        {
+          m_pieTimer = CreateObject<ShaperPieTimer> ();
+          node->AggregateObject (m_pieTimer);
+        }
+    }
+  return m_pieTimer;
 }
 
 ShaperNetDeviceFace::QueueMode
@@ -211,6 +372,12 @@ ShaperNetDeviceFace::PIEUpdate ()
   else
     qdelay = 0.0;
 
+  PIEStep (qdelay);
+}
+
+void
+ShaperNetDeviceFace::PIEStep (double qdelay)
+{
   NS_LOG_LOGIC(this << " PIE qdelay: " << qdelay << " old delay: " << m_old_delay);
 
   double tmp_p = 0.125 * (qdelay - m_delayTarget.GetSeconds()) + 1.25 * (qdelay - m_old_delay);
@@ -237,7 +404,37 @@ ShaperNetDeviceFace::PIEUpdate ()
     }
 
   m_old_delay = qdelay;
-  Simulator::Schedule (Seconds(0.03), &ShaperNetDeviceFace::PIEUpdate, this);
+}
+
+void
+ShaperNetDeviceFace::PIEResume ()
+{
+  NS_LOG_FUNCTION (this);
+
+  int64_t nextTick = GetPieTimer ()->NextTick ();
+
+  // the queue has been empty since the last update, so queueing delay for all missed updates is zero
+  while (m_pie_next_tick < nextTick)
+    {
+      double old_delay = m_old_delay;
+      double drop_prob = m_drop_prob;
+      int64_t dq_count = m_dq_count;
+      double avg_dq_rate = m_avg_dq_rate;
+      Time burst_allowance = m_burst_allowance;
+
+      PIEStep (0.0);
+      m_pie_next_tick ++;
+
+      if (old_delay == m_old_delay && drop_prob == m_drop_prob && dq_count == m_dq_count &&
+          avg_dq_rate == m_avg_dq_rate && burst_allowance == m_burst_allowance)
+        {
+          // all further updates will not change anything
+          m_pie_next_tick = nextTick;
+        }
+    }
+
+  m_pie_active = true;
+  m_pieTimer->Add (this);
 }
 
 bool
@@ -256,6 +453,13 @@ ShaperNetDeviceFace::SendImpl (Ptr<Packet> p)
         if (header->GetNack () > 0)
           return NetDeviceFace::SendImpl (p); // no shaping for NACK packets
 
+        ShaperCatchUp ();
+        if (m_mode == QUEUE_MODE_PIE && !m_pie_active)
+          PIEResume ();
+
+        if (m_mode == QUEUE_MODE_FQ_CODEL)
+          return FlowEnqueue (p, *header);
+
         NS_LOG_LOGIC(this << " shaper qlen: " << m_interestQueue.size());
 
         if(m_interestQueue.size() < m_maxInterest)
@@ -275,11 +479,9 @@ ShaperNetDeviceFace::SendImpl (Ptr<Packet> p)
               }
             else if (m_mode == QUEUE_MODE_CODEL)
               {
-                if (m_dropping && Simulator::Now() >= m_drop_next)
+                if (CoDelShouldDrop (m_codel))
                   {
                     NS_LOG_LOGIC(this << " CoDel drop");
-                    m_drop_count++;
-                    m_drop_next += Seconds(m_delayObserveInterval.GetSeconds() / sqrt(m_drop_count));
                     return false;
                   }
 
@@ -288,7 +490,9 @@ ShaperNetDeviceFace::SendImpl (Ptr<Packet> p)
               }
 
             // Enqueue success
-            m_interestQueue.push(p);
+            if (m_interestQueue.full ())
+              m_interestQueue.Reserve (m_maxInterest); // first Interest, or MaxInterest has been increased
+            m_interestQueue.push_back (p);
 
             if (m_shaperState == OPEN)
               ShaperDequeue();
@@ -325,7 +529,7 @@ ShaperNetDeviceFace::ShaperOpen ()
 {
   NS_LOG_FUNCTION (this);
 
-  if (m_interestQueue.size() > 0)
+  if (QueueSize () > 0)
     {
       ShaperDequeue();
     }
@@ -335,25 +539,40 @@ ShaperNetDeviceFace::ShaperOpen ()
 
       if (m_mode == QUEUE_MODE_CODEL)
         {
-          if (m_dropping)
-            {
-              // leave dropping state if queue is empty
-              NS_LOG_LOGIC(this << " CoDel: leave dropping state due to empty queue");
-              m_first_above_time = Seconds(0.0);
-              m_dropping = false;
-            }
+          CoDelQueueEmpty (m_codel);
         }
     }
 }
 
+void
+ShaperNetDeviceFace::ShaperCatchUp ()
+{
+  if (m_shaperState == OPEN || m_shaperOpenEvent.IsRunning ())
+    return;
+
+  // the queue has been empty since the last dequeue, and ShaperOpen has not been scheduled
+  if (Simulator::Now () >= m_shaperOpenTime)
+    ShaperOpen ();
+  else
+    m_shaperOpenEvent = Simulator::Schedule (m_shaperOpenTime - Simulator::Now (), &ShaperNetDeviceFace::ShaperOpen, this);
+}
+
 void
 ShaperNetDeviceFace::ShaperDequeue ()
 {
   NS_LOG_FUNCTION (this);
-  NS_LOG_LOGIC(this << " shaper qlen: " << m_interestQueue.size());
+  NS_LOG_LOGIC(this << " shaper qlen: " << QueueSize ());
 
-  Ptr<Packet> p = m_interestQueue.front ();
-  m_interestQueue.pop ();
+  Ptr<Packet> p;
+  if (m_mode == QUEUE_MODE_FQ_CODEL)
+    {
+      p = FlowDequeue ();
+    }
+  else
+    {
+      p = m_interestQueue.front ();
+      m_interestQueue.pop_front ();
+    }
 
   if (m_mode == QUEUE_MODE_PIE)
     {
@@ -409,35 +628,7 @@ ShaperNetDeviceFace::ShaperDequeue ()
       NS_LOG_LOGIC(this << " CoDel sojourn time: " << sojourn_time);
       p->RemovePacketTag (tag);
 
-      if (m_dropping && sojourn_time < m_delayTarget)
-        {
-          // leave dropping state
-          NS_LOG_LOGIC(this << " CoDel: leave dropping state due to low delay");
-          m_first_above_time = Seconds(0.0);
-          m_dropping = false;
-        }
-      else if (!m_dropping && sojourn_time >= m_delayTarget)
-        {
-          if (m_first_above_time == Seconds(0.0))
-            {
-              NS_LOG_LOGIC(this << " CoDel: first above time " << Simulator::Now());
-              m_first_above_time = Simulator::Now() + m_delayObserveInterval;
-            }
-          else if (Simulator::Now() >= m_first_above_time
-                   && (Simulator::Now() - m_drop_next < m_delayObserveInterval || Simulator::Now() - m_first_above_time >= m_delayObserveInterval))
-            {
-              // enter dropping state
-              NS_LOG_LOGIC(this << " CoDel: enter dropping state");
-              m_dropping = true;
-
-              if (Simulator::Now() - m_drop_next < m_delayObserveInterval)
-                m_drop_count = m_drop_count>2 ? m_drop_count-2 : 0;
-              else
-                m_drop_count = 0;
-
-              m_drop_next = Simulator::Now();
-            }
-        }
+      CoDelDequeued (m_codel, sojourn_time);
     }
 
   if (m_outInterestFirst)
@@ -496,12 +687,216 @@ ShaperNetDeviceFace::ShaperDequeue ()
 
   NS_LOG_LOGIC("Actual shaping rate: " << shapingBitRate << "bps, Gap: " << gap);
 
-  Simulator::Schedule (gap, &ShaperNetDeviceFace::ShaperOpen, this);
+  m_shaperOpenTime = Simulator::Now () + gap;
+  // if the queue is empty, there is no need for the event (see ShaperCatchUp)
+  if (QueueSize () > 0)
+    m_shaperOpenEvent = Simulator::Schedule (gap, &ShaperNetDeviceFace::ShaperOpen, this);
 
   // send out the interest
   NetDeviceFace::SendImpl (p);
 }
 
+uint32_t
+ShaperNetDeviceFace::QueueSize () const
+{
+  if (m_mode == QUEUE_MODE_FQ_CODEL)
+    return m_flowBacklog;
+  else
+    return m_interestQueue.size ();
+}
+
+bool
+ShaperNetDeviceFace::CoDelShouldDrop (CoDelState &state)
+{
+  if (state.m_dropping && Simulator::Now() >= state.m_drop_next)
+    {
+      state.m_drop_count++;
+      state.m_drop_next += Seconds(m_delayObserveInterval.GetSeconds() / sqrt(state.m_drop_count));
+      return true;
+    }
+  return false;
+}
+
+void
+ShaperNetDeviceFace::CoDelDequeued (CoDelState &state, const Time &sojourn_time)
+{
+  if (state.m_dropping && sojourn_time < m_delayTarget)
+    {
+      // leave dropping state
+      NS_LOG_LOGIC(this << " CoDel: leave dropping state due to low delay");
+      state.m_first_above_time = Seconds(0.0);
+      state.m_dropping = false;
+    }
+  else if (!state.m_dropping && sojourn_time >= m_delayTarget)
+    {
+      if (state.m_first_above_time == Seconds(0.0))
+        {
+          NS_LOG_LOGIC(this << " CoDel: first above time " << Simulator::Now());
+          state.m_first_above_time = Simulator::Now() + m_delayObserveInterval;
+        }
+      else if (Simulator::Now() >= state.m_first_above_time
+               && (Simulator::Now() - state.m_drop_next < m_delayObserveInterval || Simulator::Now() - state.m_first_above_time >= m_delayObserveInterval))
+        {
+          // enter dropping state
+          NS_LOG_LOGIC(this << " CoDel: enter dropping state");
+          state.m_dropping = true;
+
+          if (Simulator::Now() - state.m_drop_next < m_delayObserveInterval)
+            state.m_drop_count = state.m_drop_count>2 ? state.m_drop_count-2 : 0;
+          else
+            state.m_drop_count = 0;
+
+          state.m_drop_next = Simulator::Now();
+        }
+    }
+}
+
+void
+ShaperNetDeviceFace::CoDelQueueEmpty (CoDelState &state)
+{
+  if (state.m_dropping)
+    {
+      // leave dropping state if queue is empty
+      NS_LOG_LOGIC(this << " CoDel: leave dropping state due to empty queue");
+      state.m_first_above_time = Seconds(0.0);
+      state.m_dropping = false;
+    }
+}
+
+uint32_t
+ShaperNetDeviceFace::FlowIndex (const Interest &header) const
+{
+  const std::list<std::string> &components = header.GetName ().GetComponents ();
+
+  size_t length = components.size ();
+  if (m_flowPrefixLength > 0)
+    length = std::min<size_t> (length, m_flowPrefixLength);
+  else if (length > 0)
+    length --; // all but the last component (usually, sequence number)
+
+  std::size_t hash = 0;
+  std::list<std::string>::const_iterator component = components.begin ();
+  for (size_t i = 0; i < length; i++, component++)
+    {
+      boost::hash_combine (hash, *component);
+    }
+
+  return hash % m_flows.size ();
+}
+
+bool
+ShaperNetDeviceFace::FlowEnqueue (Ptr<Packet> p, const Interest &header)
+{
+  if (m_flows.empty ())
+    {
+      m_flows.resize (m_flowCount);
+      m_activeFlows.Reserve (m_flowCount);
+    }
+
+  uint32_t index = FlowIndex (header);
+  Flow &flow = m_flows[index];
+
+  NS_LOG_LOGIC(this << " shaper qlen: " << m_flowBacklog << ", flow " << index << " qlen: " << flow.m_queue.size ());
+
+  if (CoDelShouldDrop (flow.m_codel))
+    {
+      NS_LOG_LOGIC(this << " FQ-CoDel drop from flow " << index);
+      return false;
+    }
+
+  if (m_flowBacklog >= m_maxInterest && !FlowDropFromLongest (index))
+    {
+      NS_LOG_LOGIC(this << " Tail drop from flow " << index);
+      return false;
+    }
+
+  if (flow.m_queue.full ())
+    {
+      // most flows hold only a few Interests, so flow queues grow on demand (normally, not beyond MaxInterest)
+      uint32_t capacity = std::min (std::max (2 * flow.m_queue.capacity (), FLOW_QUEUE_MIN_CAPACITY), m_maxInterest);
+      flow.m_queue.Reserve (std::max (capacity, flow.m_queue.size () + 1));
+    }
+
+  Flow::Item item;
+  item.m_packet = p;
+  item.m_enqueueTime = Simulator::Now ();
+  flow.m_queue.push_back (item);
+  m_flowBacklog ++;
+
+  if (!flow.m_active)
+    {
+      flow.m_active = true;
+      flow.m_deficit = m_quantum;
+      m_activeFlows.push_back (index);
+    }
+
+  if (m_shaperState == OPEN)
+    ShaperDequeue ();
+
+  return true;
+}
+
+bool
+ShaperNetDeviceFace::FlowDropFromLongest (uint32_t index)
+{
+  uint32_t longest = index;
+  for (uint32_t i = 0; i < m_activeFlows.size (); i++)
+    {
+      if (m_flows[m_activeFlows[i]].m_queue.size () > m_flows[longest].m_queue.size ())
+        longest = m_activeFlows[i];
+    }
+
+  Flow &flow = m_flows[longest];
+
+  // never empty the flow, so it does not need to be removed from the list of active flows
+  if (longest == index || flow.m_queue.size () < 2)
+    return false;
+
+  NS_LOG_LOGIC(this << " FQ-CoDel: drop the first Interest of the longest flow " << longest);
+  flow.m_queue.pop_front ();
+  m_flowBacklog --;
+  return true;
+}
+
+Ptr<Packet>
+ShaperNetDeviceFace::FlowDequeue ()
+{
+  NS_ASSERT (m_flowBacklog > 0);
+
+  while (true)
+    {
+      uint32_t index = m_activeFlows.front ();
+      Flow &flow = m_flows[index];
+
+      if (flow.m_deficit <= 0)
+        {
+          // flow used its quantum, move it to the end of the list
+          flow.m_deficit += m_quantum;
+          m_activeFlows.pop_front ();
+          m_activeFlows.push_back (index);
+          continue;
+        }
+
+      Ptr<Packet> p = flow.m_queue.front ().m_packet;
+      Time sojourn_time = Simulator::Now () - flow.m_queue.front ().m_enqueueTime;
+      flow.m_queue.pop_front ();
+      m_flowBacklog --;
+
+      flow.m_deficit -= p->GetSize ();
+      NS_LOG_LOGIC(this << " FQ-CoDel: flow " << index << " sojourn time: " << sojourn_time);
+      CoDelDequeued (flow.m_codel, sojourn_time);
+
+      if (flow.m_queue.empty ())
+        {
+          flow.m_active = false;
+          m_activeFlows.pop_front ();
+          CoDelQueueEmpty (flow.m_codel);
+        }
+
+      return p;
+    }
+}
+
 void
 ShaperNetDeviceFace::ReceiveFromNetDevice (Ptr<NetDevice> device,
                                      Ptr<const Packet> p,
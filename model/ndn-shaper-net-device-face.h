@@ -19,14 +19,19 @@
 #ifndef NDN_SHAPER_NET_DEVICE_FACE_H
 #define NDN_SHAPER_NET_DEVICE_FACE_H
 
-#include <queue>
+#include <vector>
 #include "ndn-net-device-face.h"
 #include "ns3/net-device.h"
 #include "ns3/data-rate.h"
+#include "ns3/event-id.h"
+#include "ns3/ndnSIM/utils/ndn-ring-buffer.h"
 
 namespace ns3 {
 namespace ndn {
 
+class Interest;
+class ShaperPieTimer;
+
 /**
  * \ingroup ndn-face
  * \brief Implementation of layer-2 (Ethernet) Ndn face with interest shaping
@@ -72,6 +77,7 @@ public:
     QUEUE_MODE_DROPTAIL,
     QUEUE_MODE_PIE,
     QUEUE_MODE_CODEL,
+    QUEUE_MODE_FQ_CODEL, ///< @brief per-flow (Interest name prefix) queues served by deficit round robin, CoDel in each queue
   };
 
   /**
@@ -90,18 +96,54 @@ public:
   QueueMode GetMode (void);
 
 protected:
+  /**
+   * @brief Update PIE drop probability based on the current queueing delay
+   */
   void PIEUpdate ();
 
   virtual bool
   SendImpl (Ptr<Packet> p);
 
 private:
+  friend class ShaperPieTimer;
+
   ShaperNetDeviceFace (const ShaperNetDeviceFace &); ///< \brief Disabled copy constructor
   ShaperNetDeviceFace& operator= (const ShaperNetDeviceFace &); ///< \brief Disabled copy operator
 
+  /**
+   * @brief One step of PIE control loop for the given queueing delay (in seconds)
+   */
+  void PIEStep (double qdelay);
+
+  /**
+   * @brief Apply PIE updates missed while the face was idle and register the face in the PIE timer of the node
+   *
+   * While the face is idle (the queue is empty), queueing delay is zero, so missed updates can be
+   * calculated at once.  Calculation stops as soon as the state stops changing.
+   */
+  void PIEResume ();
+
+  /**
+   * @brief Get PIE timer shared by all faces of the node (timer is created and aggregated to the node if necessary)
+   */
+  Ptr<ShaperPieTimer> GetPieTimer ();
+
   void ShaperOpen ();
   void ShaperDequeue ();
 
+  /**
+   * @brief Total number of Interests in the shaper queue(s)
+   */
+  uint32_t QueueSize () const;
+
+  /**
+   * @brief Perform ShaperOpen actions that were skipped while the queue was empty
+   *
+   * ShaperOpen event is not scheduled if the queue becomes empty after dequeue.  Instead,
+   * state of the shaper is updated (or ShaperOpen is scheduled) when the next Interest is enqueued
+   */
+  void ShaperCatchUp ();
+
   virtual void ReceiveFromNetDevice (Ptr<NetDevice> device,
                              Ptr<const Packet> p,
                              uint16_t protocol,
@@ -109,7 +151,85 @@ private:
                              const Address &to,
                              NetDevice::PacketType packetType);
 
-  std::queue<Ptr<Packet> > m_interestQueue;
+  struct CoDelState
+  {
+    CoDelState ()
+      : m_first_above_time (0.0)
+      , m_drop_next (0.0)
+      , m_drop_count (0)
+      , m_dropping (false)
+    {
+    }
+
+    Time m_first_above_time;
+    Time m_drop_next;
+    uint32_t m_drop_count;
+    bool m_dropping;
+  };
+
+  /**
+   * @brief Check if CoDel requires to drop the Interest (and update drop schedule if it does)
+   */
+  bool CoDelShouldDrop (CoDelState &state);
+
+  /**
+   * @brief Update CoDel state based on sojourn time of the dequeued Interest
+   */
+  void CoDelDequeued (CoDelState &state, const Time &sojourn_time);
+
+  /**
+   * @brief Leave CoDel dropping state when the queue gets empty
+   */
+  void CoDelQueueEmpty (CoDelState &state);
+
+  /**
+   * @brief Sub-queue of FQ-CoDel mode
+   */
+  struct Flow
+  {
+    Flow ()
+      : m_deficit (0)
+      , m_active (false)
+    {
+    }
+
+    /**
+     * @brief Queued Interest with its enqueue time
+     */
+    struct Item
+    {
+      Ptr<Packet> m_packet;
+      Time m_enqueueTime;
+    };
+
+    RingBuffer<Item> m_queue; ///< @brief grows on demand (up to MaxInterest)
+    int32_t m_deficit; ///< @brief DRR deficit (in bytes)
+    bool m_active;     ///< @brief flow is in the list of active flows
+    CoDelState m_codel;
+  };
+
+  /**
+   * @brief Get index of the flow for the Interest (hash of the Interest name prefix)
+   */
+  uint32_t FlowIndex (const Interest &header) const;
+
+  /**
+   * @brief Enqueue Interest in FQ-CoDel mode
+   */
+  bool FlowEnqueue (Ptr<Packet> p, const Interest &header);
+
+  /**
+   * @brief Dequeue Interest in FQ-CoDel mode (deficit round robin)
+   */
+  Ptr<Packet> FlowDequeue ();
+
+  /**
+   * @brief Drop the first Interest of the longest flow, if it is longer than flow `index` (when FQ-CoDel queues are full)
+   * @returns false if nothing has been dropped
+   */
+  bool FlowDropFromLongest (uint32_t index);
+
+  RingBuffer<Ptr<Packet> > m_interestQueue;
   uint32_t m_maxInterest;
   double m_headroom;
 
@@ -138,6 +258,8 @@ private:
   };
 
   ShaperState m_shaperState;
+  Time m_shaperOpenTime; ///< @brief time when shaper can send the next Interest
+  EventId m_shaperOpenEvent;
 
   QueueMode m_mode;
   Time m_delayTarget; // for PIE or CoDel
@@ -151,12 +273,20 @@ private:
   double m_avg_dq_rate;
   Time m_dq_start;
   Time m_burst_allowance;
+  int64_t m_pie_next_tick; // index of the next tick of the PIE timer to be applied
+  bool m_pie_active; // face is registered in the PIE timer
+  Ptr<ShaperPieTimer> m_pieTimer; // PIE timer of the node
 
   // for CoDel
-  Time m_first_above_time;
-  Time m_drop_next;
-  uint32_t m_drop_count;
-  bool m_dropping;
+  CoDelState m_codel;
+
+  // for FQ-CoDel
+  uint32_t m_flowCount;
+  uint32_t m_quantum;
+  uint32_t m_flowPrefixLength;
+  std::vector<Flow> m_flows;
+  RingBuffer<uint32_t> m_activeFlows; // DRR list of flows with queued Interests
+  uint32_t m_flowBacklog; // number of Interests in all flow queues
 };
 
 } // namespace ndn
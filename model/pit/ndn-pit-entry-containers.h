@@ -0,0 +1,433 @@
+/* -*- Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2013 University of California, Los Angeles
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Alexander Afanasyev <alexander.afanasyev@ucla.edu>
+ */
+
+#ifndef _NDN_PIT_ENTRY_CONTAINERS_H_
+#define	_NDN_PIT_ENTRY_CONTAINERS_H_
+
+#include "ns3/ptr.h"
+#include "ns3/ndn-face.h"
+#include "ns3/assert.h"
+
+#include <utility>
+
+namespace ns3 {
+namespace ndn {
+namespace pit {
+
+/**
+ * \ingroup ndn
+ * \brief Compact container of per-face PIT records (IncomingFace or OutgoingFace)
+ *
+ * Records are kept ordered by face id (same iteration order as std::set) in a small
+ * inline array.  Only when more than N faces are referenced, records are moved
+ * to a heap-allocated array.  The interface mimics the subset of std::set interface
+ * that is used by PIT entry and forwarding strategies.
+ *
+ * Unlike std::set, insert and erase invalidate all iterators (and pointers to records) of the container.
+ */
+template<class Record, uint32_t N>
+class FaceRecordContainer
+{
+public:
+  typedef Record value_type;
+  typedef const Record *iterator;
+  typedef const Record *const_iterator;
+  typedef uint32_t size_type;
+
+  FaceRecordContainer ()
+    : m_data (m_inline)
+    , m_size (0)
+    , m_capacity (N)
+  {
+  }
+
+  FaceRecordContainer (const FaceRecordContainer &other)
+    : m_data (m_inline)
+    , m_size (0)
+    , m_capacity (N)
+  {
+    *this = other;
+  }
+
+  ~FaceRecordContainer ()
+  {
+    if (m_data != m_inline)
+      delete [] m_data;
+  }
+
+  FaceRecordContainer &
+  operator = (const FaceRecordContainer &other)
+  {
+    if (this == &other)
+      return *this;
+
+    clear ();
+    Reserve (other.m_size);
+    for (size_type i = 0; i < other.m_size; i++)
+      m_data[i] = other.m_data[i];
+    m_size = other.m_size;
+
+    return *this;
+  }
+
+  inline const_iterator
+  begin () const
+  {
+    return m_data;
+  }
+
+  inline const_iterator
+  end () const
+  {
+    return m_data + m_size;
+  }
+
+  inline size_type
+  size () const
+  {
+    return m_size;
+  }
+
+  inline bool
+  empty () const
+  {
+    return m_size == 0;
+  }
+
+  /**
+   * @brief Find record for the face (faces are unique objects within a node, pointer comparison is enough)
+   */
+  const_iterator
+  find (Ptr<Face> face) const
+  {
+    for (size_type i = 0; i < m_size; i++)
+      {
+        if (m_data[i].m_face == face)
+          return m_data + i;
+      }
+    return end ();
+  }
+
+  /**
+   * @brief Insert record, if there is no record for the same face yet
+   * @returns the same as std::set::insert
+   */
+  std::pair<const_iterator, bool>
+  insert (const Record &record)
+  {
+    uint32_t id = record.m_face->GetId ();
+
+    size_type pos = 0;
+    for (; pos < m_size; pos++)
+      {
+        if (m_data[pos].m_face == record.m_face)
+          return std::make_pair (m_data + pos, false);
+
+        if (id < m_data[pos].m_face->GetId ())
+          break;
+      }
+
+    if (m_size == m_capacity)
+      Reserve (m_capacity * 2);
+
+    for (size_type i = m_size; i > pos; i--)
+      m_data[i] = m_data[i-1];
+
+    m_data[pos] = record;
+    m_size ++;
+
+    return std::make_pair (m_data + pos, true);
+  }
+
+  void
+  erase (const_iterator item)
+  {
+    if (item == end ())
+      return;
+
+    for (size_type i = item - m_data; i + 1 < m_size; i++)
+      m_data[i] = m_data[i+1];
+
+    m_size --;
+    m_data[m_size] = Record (); // release reference to the face
+  }
+
+  void
+  erase (Ptr<Face> face)
+  {
+    erase (find (face));
+  }
+
+  void
+  clear ()
+  {
+    if (m_data != m_inline)
+      {
+        delete [] m_data;
+        m_data = m_inline;
+        m_capacity = N;
+      }
+    else
+      {
+        for (size_type i = 0; i < m_size; i++)
+          m_data[i] = Record ();
+      }
+    m_size = 0;
+  }
+
+private:
+  void
+  Reserve (size_type capacity)
+  {
+    if (capacity <= m_capacity)
+      return;
+
+    Record *data = new Record [capacity];
+    for (size_type i = 0; i < m_size; i++)
+      data[i] = m_data[i];
+
+    if (m_data != m_inline)
+      delete [] m_data;
+    else
+      {
+        for (size_type i = 0; i < m_size; i++)
+          m_inline[i] = Record ();
+      }
+
+    m_data = data;
+    m_capacity = capacity;
+  }
+
+private:
+  Record *m_data;
+  size_type m_size;
+  size_type m_capacity;
+  Record m_inline[N];
+};
+
+/**
+ * \ingroup ndn
+ * \brief Compact container of seen nonces
+ *
+ * By default, all nonces are kept exactly (as in std::set): the first N nonces are stored in
+ * an inline array, and only when more nonces are seen, they are moved to a heap-allocated array.
+ *
+ * In bounded mode (see SetBounded), memory does not grow instead: the last N nonces are
+ * kept exactly in a ring buffer, and nonces pushed out of the ring are recorded in a tiny (64-bit)
+ * Bloom filter.  In this mode false positives are possible for entries that have seen more than N
+ * nonces, and the false positive rate quickly grows with the number of evicted nonces (about 7%
+ * after 10 evicted nonces and about 37% after 30), so it should be used only when PIT entries are
+ * not expected to aggregate many Interests.
+ *
+ * Insert invalidates all iterators of the container.
+ */
+template<uint32_t N>
+class NonceContainer
+{
+public:
+  typedef uint32_t value_type;
+  typedef const uint32_t *iterator;
+  typedef const uint32_t *const_iterator;
+  typedef uint32_t size_type;
+
+  NonceContainer ()
+    : m_data (m_inline)
+    , m_count (0)
+    , m_capacity (N)
+    , m_bloom (0)
+    , m_bounded (false)
+  {
+  }
+
+  NonceContainer (const NonceContainer &other)
+    : m_data (m_inline)
+    , m_count (0)
+    , m_capacity (N)
+    , m_bloom (0)
+    , m_bounded (false)
+  {
+    *this = other;
+  }
+
+  ~NonceContainer ()
+  {
+    if (m_data != m_inline)
+      delete [] m_data;
+  }
+
+  NonceContainer &
+  operator = (const NonceContainer &other)
+  {
+    if (this == &other)
+      return *this;
+
+    clear ();
+    Reserve (other.m_capacity);
+    for (size_type i = 0; i < other.size (); i++)
+      m_data[i] = other.m_data[i];
+    m_count = other.m_count;
+    m_bloom = other.m_bloom;
+    m_bounded = other.m_bounded;
+
+    return *this;
+  }
+
+  /**
+   * @brief Select between exact (false, default) and memory-bounded (true) mode
+   *
+   * Mode can be changed only while the container is empty
+   */
+  void
+  SetBounded (bool bounded)
+  {
+    NS_ASSERT_MSG (m_count == 0, "Mode of NonceContainer cannot be changed after nonces have been added");
+    m_bounded = bounded;
+  }
+
+  bool
+  IsBounded () const
+  {
+    return m_bounded;
+  }
+
+  /**
+   * @brief Iterate over stored nonces (in bounded mode, only nonces that are still in the ring, in no particular order)
+   */
+  inline const_iterator
+  begin () const
+  {
+    return m_data;
+  }
+
+  inline const_iterator
+  end () const
+  {
+    return m_data + size ();
+  }
+
+  /**
+   * @brief Get number of stored nonces (in bounded mode, nonces recorded only in the filter are not counted)
+   */
+  inline size_type
+  size () const
+  {
+    return (m_bounded && m_count > N) ? N : m_count;
+  }
+
+  /**
+   * @brief Check if nonce has been seen (the same as std::set::count)
+   */
+  size_type
+  count (uint32_t nonce) const
+  {
+    for (const_iterator i = begin (); i != end (); i++)
+      {
+        if (*i == nonce)
+          return 1;
+      }
+
+    if (m_bounded && m_count > N)
+      {
+        uint64_t mask = BloomMask (nonce);
+        return (m_bloom & mask) == mask ? 1 : 0;
+      }
+
+    return 0;
+  }
+
+  void
+  insert (uint32_t nonce)
+  {
+    for (const_iterator i = begin (); i != end (); i++)
+      {
+        if (*i == nonce)
+          return;
+      }
+
+    uint32_t slot = m_count;
+    if (m_bounded)
+      {
+        slot = m_count % N;
+        if (m_count >= N)
+          m_bloom |= BloomMask (m_data[slot]);
+      }
+    else if (m_count == m_capacity)
+      {
+        Reserve (m_capacity * 2);
+      }
+
+    m_data[slot] = nonce;
+    m_count ++;
+  }
+
+  void
+  clear ()
+  {
+    if (m_data != m_inline)
+      {
+        delete [] m_data;
+        m_data = m_inline;
+        m_capacity = N;
+      }
+    m_count = 0;
+    m_bloom = 0;
+  }
+
+private:
+  void
+  Reserve (size_type capacity)
+  {
+    if (capacity <= m_capacity)
+      return;
+
+    uint32_t *data = new uint32_t [capacity];
+    for (size_type i = 0; i < m_count; i++)
+      data[i] = m_data[i];
+
+    if (m_data != m_inline)
+      delete [] m_data;
+
+    m_data = data;
+    m_capacity = capacity;
+  }
+
+  static inline uint64_t
+  BloomMask (uint32_t nonce)
+  {
+    // two "independent" bit positions from one multiplicative hash
+    uint32_t hash = nonce * 2654435761u;
+    return (static_cast<uint64_t> (1) << (hash & 0x3F)) |
+      (static_cast<uint64_t> (1) << ((hash >> 6) & 0x3F));
+  }
+
+private:
+  uint32_t *m_data;
+  uint32_t m_count;
+  uint32_t m_capacity;
+  uint64_t m_bloom;
+  bool m_bounded;
+  uint32_t m_inline[N];
+};
+
+} // namespace pit
+} // namespace ndn
+} // namespace ns3
+
+#endif // _NDN_PIT_ENTRY_CONTAINERS_H_
@@ -29,6 +29,7 @@ namespace pit {
 IncomingFace::IncomingFace (Ptr<Face> face)
   : m_face (face)
   , m_arrivalTime (Simulator::Now ())
+  , m_indexPosition (0)
   // , m_nonce (nonce)
 {
 }
@@ -36,6 +37,7 @@ IncomingFace::IncomingFace (Ptr<Face> face)
 IncomingFace::IncomingFace ()
   : m_face (0)
   , m_arrivalTime (0)
+  , m_indexPosition (0)
 {
 }
 
@@ -47,6 +49,7 @@ IncomingFace::operator = (const IncomingFace &other)
 {
   m_face = other.m_face;
   m_arrivalTime = other.m_arrivalTime;
+  m_indexPosition = other.m_indexPosition;
   return *this;
 }
 
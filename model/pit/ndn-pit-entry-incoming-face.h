@@ -38,6 +38,7 @@ struct IncomingFace
 {
   Ptr< Face > m_face; ///< \brief face of the incoming Interest
   Time m_arrivalTime;   ///< \brief arrival time of the incoming Interest
+  uint32_t m_indexPosition; ///< \brief position of the PIT entry in the per-face index of the PIT (maintained by Pit)
 
 public:
   /**
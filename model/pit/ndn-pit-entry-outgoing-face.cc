@@ -31,6 +31,7 @@ OutgoingFace::OutgoingFace (Ptr<Face> face)
   , m_sendTime (Simulator::Now ())
   , m_retxCount (0)
   , m_waitingInVain (false)
+  , m_indexPosition (0)
 {
 }
 
@@ -39,6 +40,7 @@ OutgoingFace::OutgoingFace ()
   , m_sendTime (0)
   , m_retxCount (0)
   , m_waitingInVain (false)
+  , m_indexPosition (0)
 {
 }
 
@@ -49,6 +51,7 @@ OutgoingFace::operator = (const OutgoingFace &other)
   m_sendTime = other.m_sendTime;
   m_retxCount = other.m_retxCount;
   m_waitingInVain = other.m_waitingInVain;
+  m_indexPosition = other.m_indexPosition;
 
   return *this;
 }
@@ -42,6 +42,7 @@ struct OutgoingFace
                             ///<       to TimeStamp TCP option for retransmitted (i.e., only lost interests will suffer)
   uint32_t m_retxCount;     ///< \brief number of retransmission
   bool m_waitingInVain;     ///< \brief when flag is set, we do not expect data for this interest, only a small hope that it will happen
+  uint32_t m_indexPosition; ///< \brief position of the PIT entry in the per-face index of the PIT (maintained by Pit)
 	
 public:
   /**
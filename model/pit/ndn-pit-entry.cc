@@ -46,9 +46,14 @@ Entry::Entry (Pit &container,
   , m_interest (header)
   , m_fibEntry (fibEntry)
   , m_maxRetxCount (0)
+  , m_fibPrev (0)
+  , m_fibNext (0)
 {
   NS_LOG_FUNCTION (this);
 
+  m_seenNonces.SetBounded (m_container.m_boundedNonces);
+  m_container.IndexFibEntry (this);
+
   // UpdateLifetime is (and should) be called from the forwarding strategy
 
   UpdateLifetime ((!header->GetInterestLifetime ().IsZero ()?
@@ -59,6 +64,10 @@ Entry::Entry (Pit &container,
 Entry::~Entry ()
 {
   NS_LOG_FUNCTION (GetPrefix ());
+
+  ClearIncoming ();
+  ClearOutgoing ();
+  m_container.UnindexFibEntry (this);
 }
 
 void
@@ -102,7 +111,7 @@ Entry::GetExpireTime () const
 bool
 Entry::IsNonceSeen (uint32_t nonce) const
 {
-  return m_seenNonces.find (nonce) != m_seenNonces.end ();
+  return m_seenNonces.count (nonce) > 0;
 }
 
 void
@@ -120,18 +129,31 @@ Entry::AddIncoming (Ptr<Face> face)
 
   // NS_ASSERT_MSG (ret.second, "Something is wrong");
 
+  if (ret.second)
+    const_cast<IncomingFace&> (*ret.first).m_indexPosition = m_container.IndexFace (true, face, this);
+
   return ret.first;
 }
 
 void
 Entry::RemoveIncoming (Ptr<Face> face)
 {
-  m_incoming.erase (face);
+  in_iterator item = m_incoming.find (face);
+  if (item == m_incoming.end ())
+    return;
+
+  uint32_t position = item->m_indexPosition;
+  m_incoming.erase (item);
+  m_container.UnindexFace (true, face, position);
 }
 
 void
 Entry::ClearIncoming ()
 {
+  BOOST_FOREACH (const IncomingFace &incoming, m_incoming)
+    {
+      m_container.UnindexFace (true, incoming.m_face, incoming.m_indexPosition);
+    }
   m_incoming.clear ();
 }
 
@@ -147,6 +169,10 @@ Entry::AddOutgoing (Ptr<Face> face)
       // m_outgoing.modify (ret.first,
       //                    ll::bind (&OutgoingFace::UpdateOnRetransmit, ll::_1));
     }
+  else
+    {
+      const_cast<OutgoingFace&> (*ret.first).m_indexPosition = m_container.IndexFace (false, face, this);
+    }
 
   return ret.first;
 }
@@ -154,6 +180,10 @@ Entry::AddOutgoing (Ptr<Face> face)
 void
 Entry::ClearOutgoing ()
 {
+  BOOST_FOREACH (const OutgoingFace &outgoing, m_outgoing)
+    {
+      m_container.UnindexFace (false, outgoing.m_face, outgoing.m_indexPosition);
+    }
   m_outgoing.clear ();
 }
 
@@ -161,15 +191,20 @@ void
 Entry::RemoveAllReferencesToFace (Ptr<Face> face)
 {
   in_iterator incoming = m_incoming.find (face);
-
   if (incoming != m_incoming.end ())
-    m_incoming.erase (incoming);
-
-  out_iterator outgoing =
-    m_outgoing.find (face);
+    {
+      uint32_t position = incoming->m_indexPosition;
+      m_incoming.erase (incoming);
+      m_container.UnindexFace (true, face, position);
+    }
 
+  out_iterator outgoing = m_outgoing.find (face);
   if (outgoing != m_outgoing.end ())
-    m_outgoing.erase (outgoing);
+    {
+      uint32_t position = outgoing->m_indexPosition;
+      m_outgoing.erase (outgoing);
+      m_container.UnindexFace (false, face, position);
+    }
 }
 
 // void
@@ -28,6 +28,7 @@
 
 #include "ns3/ndn-pit-entry-incoming-face.h"
 #include "ns3/ndn-pit-entry-outgoing-face.h"
+#include "ns3/ndn-pit-entry-containers.h"
 
 #include <boost/multi_index_container.hpp>
 #include <boost/multi_index/tag.hpp>
@@ -36,7 +37,6 @@
 // #include <boost/multi_index/hashed_index.hpp>
 #include <boost/multi_index/member.hpp>
 // #include <boost/multi_index/mem_fun.hpp>
-#include <set>
 #include <boost/shared_ptr.hpp>
 
 namespace ns3 {
@@ -87,18 +87,27 @@ class i_retx {};
  * \brief structure for PIT entry
  *
  * All set-methods are virtual, in case index rearrangement is necessary in the derived classes
+ *
+ * Incoming and outgoing records, as well as seen nonces, are stored in compact containers
+ * with inline storage (see FaceRecordContainer and NonceContainer), as in most cases PIT entry
+ * references just a few faces and sees just a couple of nonces.  Unlike std::set, these containers
+ * invalidate all their iterators on insert and erase, so iterators returned by AddIncoming,
+ * AddOutgoing, and GetIncoming/GetOutgoing should not be kept across modifications of the entry.
+ *
+ * By default all seen nonces are kept exactly.  If BoundedNonces attribute of the PIT is set,
+ * memory used for nonces is bounded (see NonceContainer).
  */
 class Entry : public SimpleRefCount<Entry>
 {
 public:
-  typedef std::set< IncomingFace > in_container; ///< @brief incoming faces container type
+  typedef FaceRecordContainer< IncomingFace, 2 > in_container; ///< @brief incoming faces container type
   typedef in_container::iterator in_iterator;                ///< @brief iterator to incoming faces
 
   // typedef OutgoingFaceContainer::type out_container; ///< @brief outgoing faces container type
-  typedef std::set< OutgoingFace > out_container; ///< @brief outgoing faces container type
+  typedef FaceRecordContainer< OutgoingFace, 2 > out_container; ///< @brief outgoing faces container type
   typedef out_container::iterator out_iterator;              ///< @brief iterator to outgoing faces
 
-  typedef std::set< uint32_t > nonce_container;  ///< @brief nonce container type
+  typedef NonceContainer< 4 > nonce_container;  ///< @brief nonce container type
 
   /**
    * \brief PIT entry constructor
@@ -161,7 +170,9 @@ public:
    *
    * @param nonce nonce to add to the list of seen nonces
    *
-   * All nonces are stored for the lifetime of the PIT entry
+   * By default, all seen nonces are stored exactly for the lifetime of the PIT entry, the first few without
+   * any heap allocation.  If BoundedNonces attribute of the PIT is set, only the last few nonces are stored
+   * exactly (see NonceContainer)
    */
   virtual void
   AddSeenNonce (uint32_t nonce);
@@ -296,6 +307,7 @@ public:
 
 private:
   friend std::ostream& operator<< (std::ostream& os, const Entry &entry);
+  friend class ndn::Pit;
 
 protected:
   Pit &m_container; ///< @brief Reference to the container (to rearrange indexes, if necessary)
@@ -313,6 +325,10 @@ protected:
   uint32_t m_maxRetxCount;   ///< @brief Maximum allowed number of retransmissions via outgoing faces
 
   std::list< boost::shared_ptr<fw::Tag> > m_fwTags; ///< @brief Forwarding strategy tags
+
+private:
+  Entry *m_fibPrev; ///< @brief previous PIT entry created for the same FIB entry (maintained by Pit)
+  Entry *m_fibNext; ///< @brief next PIT entry created for the same FIB entry (maintained by Pit)
 };
 
 struct EntryIsNotEmpty
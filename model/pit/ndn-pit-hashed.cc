@@ -0,0 +1,522 @@
+/* -*- Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2013 University of California, Los Angeles
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Alexander Afanasyev <alexander.afanasyev@ucla.edu>
+ */
+
+#include "ndn-pit-hashed.h"
+
+#include "ns3/ndn-interest.h"
+#include "ns3/ndn-content-object.h"
+#include "ns3/ndn-forwarding-strategy.h"
+#include "ns3/ndn-fib.h"
+#include "ns3/ndn-name.h"
+
+#include "ns3/log.h"
+#include "ns3/uinteger.h"
+#include "ns3/simulator.h"
+
+#include <boost/functional/hash.hpp>
+#include <boost/foreach.hpp>
+#include <algorithm>
+
+NS_LOG_COMPONENT_DEFINE ("ndn.pit.Hashed");
+
+namespace ns3 {
+namespace ndn {
+namespace pit {
+
+NS_OBJECT_ENSURE_REGISTERED (Hashed);
+
+const uint32_t INITIAL_CAPACITY = 64; // should be power of 2
+
+HashedEntry::HashedEntry (Hashed &pit,
+                          Ptr<const Interest> header,
+                          Ptr<fib::Entry> fibEntry,
+                          std::size_t hash)
+  : Entry (pit, header, fibEntry)
+  , m_hash (hash)
+{
+}
+
+HashedEntry::~HashedEntry ()
+{
+  if (time_hook_.is_linked ())
+    {
+      Hashed &pit = static_cast<Hashed&> (m_container);
+      pit.i_time.erase (Hashed::time_index::s_iterator_to (*this));
+      pit.RescheduleCleaning ();
+    }
+}
+
+void
+HashedEntry::UpdateLifetime (const Time &offsetTime)
+{
+  if (!time_hook_.is_linked ())
+    {
+      // entry is not (or no longer) in PIT
+      super::UpdateLifetime (offsetTime);
+      return;
+    }
+
+  Hashed &pit = static_cast<Hashed&> (m_container);
+  pit.i_time.erase (Hashed::time_index::s_iterator_to (*this));
+  super::UpdateLifetime (offsetTime);
+  pit.i_time.insert (*this);
+
+  pit.RescheduleCleaning ();
+}
+
+void
+HashedEntry::OffsetLifetime (const Time &offsetTime)
+{
+  if (!time_hook_.is_linked ())
+    {
+      super::OffsetLifetime (offsetTime);
+      return;
+    }
+
+  Hashed &pit = static_cast<Hashed&> (m_container);
+  pit.i_time.erase (Hashed::time_index::s_iterator_to (*this));
+  super::OffsetLifetime (offsetTime);
+  pit.i_time.insert (*this);
+
+  pit.RescheduleCleaning ();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+
+TypeId
+Hashed::GetTypeId ()
+{
+  static TypeId tid = TypeId ("ns3::ndn::pit::Hashed")
+    .SetGroupName ("Ndn")
+    .SetParent<Pit> ()
+    .AddConstructor< Hashed > ()
+    .AddAttribute ("MaxSize",
+                   "Set maximum number of entries in PIT. If 0, limit is not enforced",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&Hashed::GetMaxSize,
+                                         &Hashed::SetMaxSize),
+                   MakeUintegerChecker<uint32_t> ())
+
+    .AddAttribute ("CurrentSize", "Get current number of entries in PIT",
+                   TypeId::ATTR_GET,
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&Hashed::GetSize),
+                   MakeUintegerChecker<uint32_t> ())
+    ;
+
+  return tid;
+}
+
+Hashed::Hashed ()
+  : m_slots (INITIAL_CAPACITY)
+  , m_size (0)
+  , m_maxSize (0)
+{
+}
+
+Hashed::~Hashed ()
+{
+}
+
+uint32_t
+Hashed::GetMaxSize () const
+{
+  return m_maxSize;
+}
+
+void
+Hashed::SetMaxSize (uint32_t maxSize)
+{
+  m_maxSize = maxSize;
+}
+
+void
+Hashed::NotifyNewAggregate ()
+{
+  if (m_fib == 0)
+    {
+      m_fib = GetObject<Fib> ();
+    }
+  if (m_forwardingStrategy == 0)
+    {
+      m_forwardingStrategy = GetObject<ForwardingStrategy> ();
+    }
+
+  Pit::NotifyNewAggregate ();
+}
+
+void
+Hashed::DoDispose ()
+{
+  Simulator::Remove (m_cleanEvent);
+
+  i_time.clear ();
+  m_slots.clear ();
+  m_nameLengths.clear ();
+  m_size = 0;
+
+  m_forwardingStrategy = 0;
+  m_fib = 0;
+
+  Pit::DoDispose ();
+}
+
+void
+Hashed::RescheduleCleaning ()
+{
+  // m_cleanEvent.Cancel ();
+  Simulator::Remove (m_cleanEvent); // slower, but better for memory
+  if (i_time.empty ())
+    {
+      return;
+    }
+
+  Time nextEvent = i_time.begin ()->GetExpireTime () - Simulator::Now ();
+  if (nextEvent <= 0) nextEvent = Seconds (0);
+
+  NS_LOG_DEBUG ("Schedule next cleaning in " <<
+                nextEvent.ToDouble (Time::S) << "s (at " <<
+                i_time.begin ()->GetExpireTime () << "s abs time");
+
+  m_cleanEvent = Simulator::Schedule (nextEvent,
+                                      &Hashed::CleanExpired, this);
+}
+
+void
+Hashed::CleanExpired ()
+{
+  NS_LOG_LOGIC ("Cleaning PIT. Total: " << i_time.size ());
+  Time now = Simulator::Now ();
+
+  while (!i_time.empty ())
+    {
+      time_index::iterator entry = i_time.begin ();
+      if (entry->GetExpireTime () <= now) // is the record stale?
+        {
+          Ptr<HashedEntry> item = &(*entry);
+          m_forwardingStrategy->FindStrategy (item->GetFibEntry ())->WillEraseTimedOutPendingInterest (item);
+          Erase (item);
+        }
+      else
+        break; // nothing else to do. All later records will not be stale
+    }
+
+  RescheduleCleaning ();
+}
+
+void
+Hashed::CalculatePrefixHashes (const Name &name) const
+{
+  m_hashes.resize (name.size () + 1);
+
+  std::size_t hash = 0;
+  m_hashes[0] = hash;
+
+  uint32_t length = 0;
+  for (Name::const_iterator component = name.begin (); component != name.end (); component++)
+    {
+      boost::hash_combine (hash, *component);
+      m_hashes[++length] = hash;
+    }
+}
+
+uint32_t
+Hashed::FindSlot (const Name &name, uint32_t length, std::size_t hash) const
+{
+  uint32_t mask = m_slots.size () - 1;
+  for (uint32_t i = hash & mask; m_slots[i].m_entry != 0; i = (i + 1) & mask)
+    {
+      if (m_slots[i].m_hash != hash)
+        continue;
+
+      const Name &prefix = m_slots[i].m_entry->GetPrefix ();
+      if (prefix.size () == length &&
+          std::equal (prefix.begin (), prefix.end (), name.begin ()))
+        {
+          return i;
+        }
+    }
+
+  return m_slots.size ();
+}
+
+uint32_t
+Hashed::FindSlot (Ptr<const HashedEntry> entry) const
+{
+  uint32_t mask = m_slots.size () - 1;
+  for (uint32_t i = entry->GetHash () & mask; m_slots[i].m_entry != 0; i = (i + 1) & mask)
+    {
+      if (m_slots[i].m_entry == entry)
+        return i;
+    }
+
+  return m_slots.size ();
+}
+
+void
+Hashed::Insert (Ptr<HashedEntry> entry)
+{
+  if ((m_size + 1) * 2 > m_slots.size ())
+    {
+      Grow ();
+    }
+
+  uint32_t mask = m_slots.size () - 1;
+  uint32_t i = entry->GetHash () & mask;
+  while (m_slots[i].m_entry != 0)
+    {
+      i = (i + 1) & mask;
+    }
+
+  m_slots[i].m_hash = entry->GetHash ();
+  m_slots[i].m_entry = entry;
+  m_size ++;
+
+  uint32_t length = entry->GetPrefix ().size ();
+  if (m_nameLengths.size () <= length)
+    {
+      m_nameLengths.resize (length + 1, 0);
+    }
+  m_nameLengths[length] ++;
+
+  i_time.insert (*entry);
+  RescheduleCleaning ();
+}
+
+void
+Hashed::Erase (Ptr<HashedEntry> entry)
+{
+  uint32_t i = FindSlot (entry);
+  NS_ASSERT_MSG (i != m_slots.size (), "Entry should be in PIT");
+
+  i_time.erase (time_index::s_iterator_to (*entry));
+
+  m_nameLengths[entry->GetPrefix ().size ()] --;
+  m_size --;
+
+  // backward shift deletion (no tombstones)
+  uint32_t mask = m_slots.size () - 1;
+  m_slots[i] = Slot ();
+  for (uint32_t j = (i + 1) & mask; m_slots[j].m_entry != 0; j = (j + 1) & mask)
+    {
+      uint32_t home = m_slots[j].m_hash & mask;
+
+      bool inPlace = (i <= j) ? (i < home && home <= j) : (i < home || home <= j);
+      if (inPlace)
+        continue;
+
+      m_slots[i] = m_slots[j];
+      m_slots[j] = Slot ();
+      i = j;
+    }
+
+  RescheduleCleaning ();
+}
+
+void
+Hashed::Grow ()
+{
+  std::vector<Slot> slots (m_slots.size () * 2);
+  uint32_t mask = slots.size () - 1;
+
+  BOOST_FOREACH (const Slot &slot, m_slots)
+    {
+      if (slot.m_entry == 0)
+        continue;
+
+      uint32_t i = slot.m_hash & mask;
+      while (slots[i].m_entry != 0)
+        {
+          i = (i + 1) & mask;
+        }
+      slots[i] = slot;
+    }
+
+  m_slots.swap (slots);
+}
+
+Ptr<Entry>
+Hashed::Lookup (const ContentObject &header)
+{
+  const Name &name = header.GetName ();
+  CalculatePrefixHashes (name);
+
+  // Longest prefix match with non-empty PIT entry.  Only prefix lengths for which there
+  // are entries in PIT are checked
+  int32_t maxLength = std::min<int32_t> (name.size (), static_cast<int32_t> (m_nameLengths.size ()) - 1);
+  for (int32_t length = maxLength; length >= 0; length--)
+    {
+      if (m_nameLengths[length] == 0)
+        continue;
+
+      uint32_t i = FindSlot (name, length, m_hashes[length]);
+      if (i != m_slots.size () && !m_slots[i].m_entry->GetIncoming ().empty ())
+        {
+          return m_slots[i].m_entry;
+        }
+    }
+
+  return 0;
+}
+
+void
+Hashed::LookupAll (const ContentObject &header, std::vector< Ptr<Entry> > &entries)
+{
+  const Name &name = header.GetName ();
+  CalculatePrefixHashes (name);
+
+  int32_t maxLength = std::min<int32_t> (name.size (), static_cast<int32_t> (m_nameLengths.size ()) - 1);
+  for (int32_t length = maxLength; length >= 0; length--)
+    {
+      if (m_nameLengths[length] == 0)
+        continue;
+
+      uint32_t i = FindSlot (name, length, m_hashes[length]);
+      if (i != m_slots.size () && !m_slots[i].m_entry->GetIncoming ().empty ())
+        {
+          entries.push_back (m_slots[i].m_entry);
+        }
+    }
+}
+
+Ptr<Entry>
+Hashed::Lookup (const Interest &header)
+{
+  NS_ASSERT_MSG (m_fib != 0, "FIB should be set");
+  NS_ASSERT_MSG (m_forwardingStrategy != 0, "Forwarding strategy  should be set");
+
+  return Find (header.GetName ());
+}
+
+Ptr<Entry>
+Hashed::Find (const Name &prefix)
+{
+  const uint32_t length = prefix.size ();
+  if (length >= m_nameLengths.size () || m_nameLengths[length] == 0)
+    return 0;
+
+  CalculatePrefixHashes (prefix);
+
+  uint32_t i = FindSlot (prefix, length, m_hashes[length]);
+  if (i == m_slots.size ())
+    return 0;
+  else
+    return m_slots[i].m_entry;
+}
+
+Ptr<Entry>
+Hashed::Create (Ptr<const Interest> header)
+{
+  NS_LOG_DEBUG (header->GetName ());
+
+  const Name &name = header->GetName ();
+  CalculatePrefixHashes (name);
+  std::size_t hash = m_hashes[name.size ()];
+
+  uint32_t i = FindSlot (name, name.size (), hash);
+  if (i != m_slots.size ())
+    {
+      return m_slots[i].m_entry;
+    }
+
+  if (m_maxSize != 0 && m_size >= m_maxSize)
+    {
+      return 0;
+    }
+
+  Ptr<fib::Entry> fibEntry = m_fib->LongestPrefixMatch (*header);
+  if (fibEntry == 0)
+    return 0;
+
+  Ptr<HashedEntry> newEntry = ns3::Create<HashedEntry> (boost::ref (*this), header, fibEntry, hash);
+  Insert (newEntry);
+
+  return newEntry;
+}
+
+void
+Hashed::MarkErased (Ptr<Entry> item)
+{
+  if (this->m_PitEntryPruningTimout.IsZero ())
+    {
+      Erase (StaticCast<HashedEntry> (item));
+    }
+  else
+    {
+      item->OffsetLifetime (this->m_PitEntryPruningTimout - item->GetExpireTime () + Simulator::Now ());
+    }
+}
+
+void
+Hashed::Print (std::ostream& os) const
+{
+  // entries are printed in hash table order
+  BOOST_FOREACH (const Slot &slot, m_slots)
+    {
+      if (slot.m_entry == 0) continue;
+
+      os << slot.m_entry->GetPrefix () << "\t" << *slot.m_entry << "\n";
+    }
+}
+
+uint32_t
+Hashed::GetSize () const
+{
+  return m_size;
+}
+
+Ptr<Entry>
+Hashed::Begin ()
+{
+  for (uint32_t i = 0; i < m_slots.size (); i++)
+    {
+      if (m_slots[i].m_entry != 0)
+        return m_slots[i].m_entry;
+    }
+
+  return End ();
+}
+
+Ptr<Entry>
+Hashed::End ()
+{
+  return 0;
+}
+
+Ptr<Entry>
+Hashed::Next (Ptr<Entry> from)
+{
+  if (from == 0) return 0;
+
+  uint32_t i = FindSlot (StaticCast<HashedEntry> (from));
+  for (i++; i < m_slots.size (); i++)
+    {
+      if (m_slots[i].m_entry != 0)
+        return m_slots[i].m_entry;
+    }
+
+  return End ();
+}
+
+} // namespace pit
+} // namespace ndn
+} // namespace ns3
@@ -0,0 +1,229 @@
+/* -*- Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2013 University of California, Los Angeles
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Alexander Afanasyev <alexander.afanasyev@ucla.edu>
+ */
+
+#ifndef _NDN_PIT_HASHED_H_
+#define	_NDN_PIT_HASHED_H_
+
+#include "ndn-pit.h"
+
+#include "ns3/event-id.h"
+
+#include <boost/intrusive/set.hpp>
+#include "ndn-pit-entry-impl.h"
+
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+
+class ForwardingStrategy;
+
+namespace pit {
+
+class Hashed;
+
+/**
+ * \ingroup ndn
+ * \brief PIT entry for the hash-based PIT implementation (Hashed)
+ */
+class HashedEntry : public Entry
+{
+public:
+  typedef Entry super;
+
+  HashedEntry (Hashed &pit,
+               Ptr<const Interest> header,
+               Ptr<fib::Entry> fibEntry,
+               std::size_t hash);
+
+  virtual ~HashedEntry ();
+
+  virtual void
+  UpdateLifetime (const Time &offsetTime);
+
+  virtual void
+  OffsetLifetime (const Time &offsetTime);
+
+  /**
+   * @brief Get hash of the full name of the entry
+   */
+  inline std::size_t
+  GetHash () const;
+
+public:
+  boost::intrusive::set_member_hook<> time_hook_;
+
+private:
+  std::size_t m_hash;
+};
+
+/**
+ * \ingroup ndn
+ * \brief PIT implementation based on a single open-addressing hash table
+ *
+ * Entries are indexed by hash of the full Interest name, so Lookup for an Interest
+ * is a single exact-match probe instead of a trie walk.  Lookup for a Data packet
+ * probes only those prefix lengths of the Data name for which the PIT currently has
+ * at least one entry (in the common case, when all Interests carry full names,
+ * this is again a single probe).
+ *
+ * Similar to pit::Persistent, new entries are rejected when MaxSize limit is reached.
+ */
+class Hashed : public Pit
+{
+public:
+  /**
+   * \brief Interface ID
+   *
+   * \return interface ID
+   */
+  static TypeId GetTypeId ();
+
+  /**
+   * \brief PIT constructor
+   */
+  Hashed ();
+
+  /**
+   * \brief Destructor
+   */
+  virtual ~Hashed ();
+
+  // inherited from Pit
+  virtual Ptr<Entry>
+  Lookup (const ContentObject &header);
+
+  virtual void
+  LookupAll (const ContentObject &header, std::vector< Ptr<Entry> > &entries);
+
+  virtual Ptr<Entry>
+  Lookup (const Interest &header);
+
+  virtual Ptr<Entry>
+  Find (const Name &prefix);
+
+  virtual Ptr<Entry>
+  Create (Ptr<const Interest> header);
+
+  virtual void
+  MarkErased (Ptr<Entry> entry);
+
+  virtual void
+  Print (std::ostream &os) const;
+
+  virtual uint32_t
+  GetSize () const;
+
+  virtual Ptr<Entry>
+  Begin ();
+
+  virtual Ptr<Entry>
+  End ();
+
+  virtual Ptr<Entry>
+  Next (Ptr<Entry>);
+
+protected:
+  void RescheduleCleaning ();
+  void CleanExpired ();
+
+  // inherited from Object class
+  virtual void NotifyNewAggregate (); ///< @brief Even when object is aggregated to another Object
+  virtual void DoDispose (); ///< @brief Do cleanup
+
+private:
+  struct Slot
+  {
+    Slot () : m_hash (0) { }
+
+    std::size_t m_hash;
+    Ptr<HashedEntry> m_entry;
+  };
+
+  /**
+   * @brief Calculate hashes of all prefixes of the name (m_hashes[i] is hash of the first i components)
+   */
+  void
+  CalculatePrefixHashes (const Name &name) const;
+
+  /**
+   * @brief Find slot of the entry, whose name is equal to the first `length` components of `name`
+   * @returns index of the slot or m_slots.size () if there is no such entry
+   */
+  uint32_t
+  FindSlot (const Name &name, uint32_t length, std::size_t hash) const;
+
+  /**
+   * @brief Find slot that holds exactly this entry
+   */
+  uint32_t
+  FindSlot (Ptr<const HashedEntry> entry) const;
+
+  void
+  Insert (Ptr<HashedEntry> entry);
+
+  void
+  Erase (Ptr<HashedEntry> entry);
+
+  void
+  Grow ();
+
+  uint32_t
+  GetMaxSize () const;
+
+  void
+  SetMaxSize (uint32_t maxSize);
+
+private:
+  std::vector<Slot> m_slots; ///< @brief open-addressing table (linear probing), size is always power of 2
+  uint32_t m_size;
+  uint32_t m_maxSize;
+
+  std::vector<uint32_t> m_nameLengths; ///< @brief number of entries for each name length (in components)
+  mutable std::vector<std::size_t> m_hashes; ///< @brief scratch space for prefix hashes
+
+  EventId m_cleanEvent;
+  Ptr<Fib> m_fib; ///< \brief Link to FIB table
+  Ptr<ForwardingStrategy> m_forwardingStrategy;
+
+  // indexes
+  typedef
+  boost::intrusive::multiset<HashedEntry,
+                             boost::intrusive::compare < TimestampIndex< HashedEntry > >,
+                             boost::intrusive::member_hook< HashedEntry,
+                                                            boost::intrusive::set_member_hook<>,
+                                                            &HashedEntry::time_hook_>
+                             > time_index;
+  time_index i_time;
+
+  friend class HashedEntry;
+};
+
+inline std::size_t
+HashedEntry::GetHash () const
+{
+  return m_hash;
+}
+
+} // namespace pit
+} // namespace ndn
+} // namespace ns3
+
+#endif	/* _NDN_PIT_HASHED_H_ */
@@ -83,6 +83,9 @@ public:
   virtual Ptr<Entry>
   Lookup (const ContentObject &header);
 
+  virtual void
+  LookupAll (const ContentObject &header, std::vector< Ptr<Entry> > &entries);
+
   virtual Ptr<Entry>
   Lookup (const Interest &header);
 
@@ -282,7 +285,8 @@ PitImpl<Policy>::CleanExpired ()
       typename time_index::iterator entry = i_time.begin ();
       if (entry->GetExpireTime () <= now) // is the record stale?
         {
-          m_forwardingStrategy->WillEraseTimedOutPendingInterest (entry->to_iterator ()->payload ());
+          Ptr<Entry> pitEntry = entry->to_iterator ()->payload ();
+          m_forwardingStrategy->FindStrategy (pitEntry->GetFibEntry ())->WillEraseTimedOutPendingInterest (pitEntry);
           super::erase (entry->to_iterator ());
           // count ++;
         }
@@ -311,6 +315,21 @@ PitImpl<Policy>::Lookup (const ContentObject &header)
     return item->payload (); // which could also be 0
 }
 
+template<class Policy>
+void
+PitImpl<Policy>::LookupAll (const ContentObject &header, std::vector< Ptr<Entry> > &entries)
+{
+  std::vector<typename super::iterator> items;
+  super::all_prefix_matches_if (header.GetName (), EntryIsNotEmpty (), items);
+
+  for (typename std::vector<typename super::iterator>::iterator item = items.begin ();
+       item != items.end ();
+       item++)
+    {
+      entries.push_back ((*item)->payload ());
+    }
+}
+
 template<class Policy>
 Ptr<Entry>
 PitImpl<Policy>::Lookup (const Interest &header)
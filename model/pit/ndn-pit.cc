@@ -24,12 +24,15 @@
 #include "ns3/ndn-content-object.h"
 
 #include "ns3/log.h"
+#include "ns3/assert.h"
 #include "ns3/nstime.h"
 #include "ns3/uinteger.h"
+#include "ns3/boolean.h"
 #include "ns3/simulator.h"
 
 #include <boost/lambda/bind.hpp>
 #include <boost/lambda/lambda.hpp>
+#include <boost/foreach.hpp>
 
 NS_LOG_COMPONENT_DEFINE ("ndn.Pit");
 
@@ -57,12 +60,21 @@ Pit::GetTypeId ()
                    TimeValue (), // by default, PIT entries are kept for the time, specified by the InterestLifetime
                    MakeTimeAccessor (&Pit::GetMaxPitEntryLifetime, &Pit::SetMaxPitEntryLifetime),
                    MakeTimeChecker ())
+
+    .AddAttribute ("BoundedNonces",
+                   "If true, PIT entries keep only the last few nonces exactly and record older ones in a small Bloom filter "
+                   "(memory per entry is bounded, but false duplicate detections are possible for entries that aggregate many Interests). "
+                   "If false, all seen nonces are kept exactly",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&Pit::m_boundedNonces),
+                   MakeBooleanChecker ())
     ;
 
   return tid;
 }
 
 Pit::Pit ()
+  : m_boundedNonces (false)
 {
 }
 
@@ -70,5 +82,107 @@ Pit::~Pit ()
 {
 }
 
+void
+Pit::FindEntriesWithFace (Ptr<Face> face, std::vector< Ptr<pit::Entry> > &entries) const
+{
+  uint32_t id = face->GetId ();
+
+  if (id < m_incomingIndex.size ())
+    {
+      BOOST_FOREACH (pit::Entry *entry, m_incomingIndex[id])
+        {
+          entries.push_back (Ptr<pit::Entry> (entry));
+        }
+    }
+
+  if (id < m_outgoingIndex.size ())
+    {
+      BOOST_FOREACH (pit::Entry *entry, m_outgoingIndex[id])
+        {
+          // entries that have both incoming and outgoing records for the face are already added
+          if (entry->m_incoming.find (face) == entry->m_incoming.end ())
+            entries.push_back (Ptr<pit::Entry> (entry));
+        }
+    }
+}
+
+void
+Pit::FindEntriesWithFibEntry (Ptr<const fib::Entry> fibEntry, std::vector< Ptr<pit::Entry> > &entries) const
+{
+  for (pit::Entry *entry = fibEntry->m_pitEntries; entry != 0; entry = entry->m_fibNext)
+    {
+      entries.push_back (Ptr<pit::Entry> (entry));
+    }
+}
+
+uint32_t
+Pit::IndexFace (bool incoming, Ptr<Face> face, pit::Entry *entry)
+{
+  FaceIndex &index = incoming ? m_incomingIndex : m_outgoingIndex;
+
+  uint32_t id = face->GetId ();
+  NS_ASSERT_MSG (id != (uint32_t)-1, "Face should be added to the NDN stack before it is referenced in PIT");
+  if (index.size () <= id)
+    index.resize (id + 1);
+
+  index[id].push_back (entry);
+  return index[id].size () - 1;
+}
+
+void
+Pit::UnindexFace (bool incoming, Ptr<Face> face, uint32_t position)
+{
+  FaceIndex &index = incoming ? m_incomingIndex : m_outgoingIndex;
+
+  std::vector<pit::Entry*> &entries = index[face->GetId ()];
+  NS_ASSERT (position < entries.size ());
+
+  if (position + 1 < entries.size ())
+    {
+      pit::Entry *moved = entries.back ();
+      entries[position] = moved;
+
+      // the same PIT entry cannot be indexed twice for the same face, so the record still exists
+      if (incoming)
+        const_cast<pit::IncomingFace&> (*moved->m_incoming.find (face)).m_indexPosition = position;
+      else
+        const_cast<pit::OutgoingFace&> (*moved->m_outgoing.find (face)).m_indexPosition = position;
+    }
+  entries.pop_back ();
+}
+
+void
+Pit::IndexFibEntry (pit::Entry *entry)
+{
+  Ptr<fib::Entry> fibEntry = entry->m_fibEntry;
+  if (fibEntry == 0)
+    return;
+
+  entry->m_fibPrev = 0;
+  entry->m_fibNext = fibEntry->m_pitEntries;
+  if (fibEntry->m_pitEntries != 0)
+    fibEntry->m_pitEntries->m_fibPrev = entry;
+  fibEntry->m_pitEntries = entry;
+}
+
+void
+Pit::UnindexFibEntry (pit::Entry *entry)
+{
+  Ptr<fib::Entry> fibEntry = entry->m_fibEntry;
+  if (fibEntry == 0)
+    return;
+
+  if (entry->m_fibPrev != 0)
+    entry->m_fibPrev->m_fibNext = entry->m_fibNext;
+  else
+    fibEntry->m_pitEntries = entry->m_fibNext;
+
+  if (entry->m_fibNext != 0)
+    entry->m_fibNext->m_fibPrev = entry->m_fibPrev;
+
+  entry->m_fibPrev = 0;
+  entry->m_fibNext = 0;
+}
+
 } // namespace ndn
 } // namespace ns3
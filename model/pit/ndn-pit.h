@@ -27,6 +27,8 @@
 
 #include "ndn-pit-entry.h"
 
+#include <vector>
+
 namespace ns3 {
 namespace ndn {
 
@@ -79,6 +81,18 @@ public:
   virtual Ptr<pit::Entry>
   Lookup (const ContentObject &header) = 0;
 
+  /**
+   * \brief Find all non-empty PIT entries that can be satisfied by the content object
+   *
+   * Unlike Lookup (const ContentObject&), all PIT entries with prefixes of the content object name
+   * are found during a single lookup.
+   *
+   * \param header parsed content object header
+   * \param entries container to which found PIT entries are appended (from the longest to the shortest prefix)
+   */
+  virtual void
+  LookupAll (const ContentObject &header, std::vector< Ptr<pit::Entry> > &entries) = 0;
+
   /**
    * \brief Find a PIT entry for the given content interest
    * \param header parsed interest header
@@ -150,6 +164,27 @@ public:
   virtual Ptr<pit::Entry>
   Next (Ptr<pit::Entry>) = 0;
 
+  /**
+   * @brief Find all PIT entries that have incoming or outgoing record for the face
+   *
+   * @param face face
+   * @param entries container to which found PIT entries are appended
+   */
+  void
+  FindEntriesWithFace (Ptr<Face> face, std::vector< Ptr<pit::Entry> > &entries) const;
+
+  /**
+   * @brief Find all PIT entries that were created for the FIB entry
+   *
+   * Note that returned entries may include entries that are already removed from PIT, but are still
+   * referenced elsewhere (e.g., by scheduled events)
+   *
+   * @param fibEntry FIB entry
+   * @param entries container to which found PIT entries are appended
+   */
+  void
+  FindEntriesWithFibEntry (Ptr<const fib::Entry> fibEntry, std::vector< Ptr<pit::Entry> > &entries) const;
+
   ////////////////////////////////////////////////////////////////////////////
   ////////////////////////////////////////////////////////////////////////////
   ////////////////////////////////////////////////////////////////////////////
@@ -177,6 +212,45 @@ protected:
   Time m_PitEntryPruningTimout;
 
   Time m_maxPitEntryLifetime;
+
+  bool m_boundedNonces; ///< @brief mode of nonce containers of new PIT entries (see pit::NonceContainer::SetBounded)
+
+private:
+  friend class pit::Entry;
+
+  /**
+   * @brief Called by PIT entry when incoming (`incoming` is true) or outgoing record for the face is created
+   * @returns position of the PIT entry in the per-face index, which should be stored in the record
+   */
+  uint32_t
+  IndexFace (bool incoming, Ptr<Face> face, pit::Entry *entry);
+
+  /**
+   * @brief Called by PIT entry when incoming or outgoing record for the face is removed
+   *
+   * The last PIT entry of the per-face index is moved to the vacated position (its record is updated accordingly)
+   */
+  void
+  UnindexFace (bool incoming, Ptr<Face> face, uint32_t position);
+
+  /**
+   * @brief Link PIT entry into the list of PIT entries of its FIB entry
+   */
+  void
+  IndexFibEntry (pit::Entry *entry);
+
+  /**
+   * @brief Unlink PIT entry from the list of PIT entries of its FIB entry
+   */
+  void
+  UnindexFibEntry (pit::Entry *entry);
+
+private:
+  typedef std::vector< std::vector<pit::Entry*> > FaceIndex;
+
+  // reverse indexes, so removing a face does not require walking the whole PIT
+  FaceIndex m_incomingIndex; ///< @brief PIT entries with incoming record for the face (indexed by face ID)
+  FaceIndex m_outgoingIndex; ///< @brief PIT entries with outgoing record for the face (indexed by face ID)
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -151,4 +151,98 @@ FibEntryTest::DoRun ()
   NS_TEST_ASSERT_MSG_EQ (recorders.front ()->count, 2, "two events should have been reported");
 }
 
+void
+FibEntryRankTest::CheckRank (Ptr<ndn::fib::Entry> entry, const std::string &step)
+{
+  const ndn::fib::FaceMetricContainer::type &faces = entry->m_faces;
+  for (uint32_t i = 1; i < faces.size (); i++)
+    {
+      const ndn::fib::FaceMetric &a = faces.get<ndn::fib::i_nth> () [i-1];
+      const ndn::fib::FaceMetric &b = faces.get<ndn::fib::i_nth> () [i];
+
+      bool ordered =
+        a.GetStatus () < b.GetStatus () ||
+        (a.GetStatus () == b.GetStatus () &&
+         (a.GetRoutingCost () < b.GetRoutingCost () ||
+          (a.GetRoutingCost () == b.GetRoutingCost () && a.GetNackRatio () <= b.GetNackRatio ())));
+
+      NS_TEST_ASSERT_MSG_EQ (ordered, true, "Faces should be in the rank order after " << step);
+    }
+}
+
+void
+FibEntryRankTest::CheckBest (Ptr<ndn::fib::Entry> entry, uint32_t faceId, const std::string &step)
+{
+  NS_TEST_ASSERT_MSG_EQ (entry->FindBestCandidate (0).GetFace ()->GetId (), faceId, "Unexpected best face after " << step);
+}
+
+void
+FibEntryRankTest::DoRun ()
+{
+  Ptr<Node> node = CreateObject<Node> ();
+  NodeContainer neighbors;
+  neighbors.Create (3);
+
+  PointToPointHelper p2p;
+  for (uint32_t i = 0; i < neighbors.GetN (); i++)
+    p2p.Install (node, neighbors.Get (i));
+
+  ndn::StackHelper ndn;
+  ndn.Install (node);
+
+  Ptr<ndn::L3Protocol> l3 = node->GetObject<ndn::L3Protocol> ();
+  Ptr<ndn::Face> face0 = l3->GetFace (0);
+  Ptr<ndn::Face> face1 = l3->GetFace (1);
+  Ptr<ndn::Face> face2 = l3->GetFace (2);
+
+  Ptr<ndn::fib::Entry> entry = node->GetObject<ndn::Fib> ()->Add (ndn::Name ("/prefix"), face0, 30);
+  entry->AddOrUpdateRoutingMetric (face1, 20);
+  entry->AddOrUpdateRoutingMetric (face2, 10);
+  CheckRank (entry, "adding faces");
+  CheckBest (entry, face2->GetId (), "adding faces");
+
+  uint32_t version = entry->m_faces.GetVersion ();
+  entry->UpdateStatus (face0, ndn::fib::FaceMetric::NDN_FIB_GREEN);
+  CheckRank (entry, "status update");
+  CheckBest (entry, face0->GetId (), "status update");
+  NS_TEST_ASSERT_MSG_EQ ((entry->m_faces.GetVersion () != version), true, "Version should change after status update");
+
+  entry->Invalidate (face0);
+  CheckRank (entry, "invalidating face");
+  CheckBest (entry, face2->GetId (), "invalidating face");
+
+  entry->AddOrUpdateRoutingMetric (face0, 5);
+  CheckRank (entry, "routing metric update");
+  CheckBest (entry, face0->GetId (), "routing metric update");
+
+  // equal status and cost, faces should be ranked by NACK ratio
+  entry->AddOrUpdateRoutingMetric (face1, 5);
+  entry->AddOrUpdateRoutingMetric (face2, 5);
+  version = entry->m_faces.GetVersion ();
+  const_cast<ndn::fib::FaceMetric &> (*entry->m_faces.find (face0)).SetNackRate (0.5);
+  CheckRank (entry, "setting NACK ratio");
+  NS_TEST_ASSERT_MSG_EQ ((entry->FindBestCandidate (0).GetFace () != face0), true, "Face with high NACK ratio should not be the best");
+  NS_TEST_ASSERT_MSG_EQ ((entry->m_faces.GetVersion () != version), true, "Version should change after NACK ratio update");
+
+  // NACK ratio is recalculated periodically from counters
+  const_cast<ndn::fib::FaceMetric &> (*entry->m_faces.find (face0)).SetNackRate (1e-6);
+  const_cast<ndn::fib::FaceMetric &> (*entry->m_faces.find (face1)).SetNackRate (1e-6);
+  const_cast<ndn::fib::FaceMetric &> (*entry->m_faces.find (face2)).SetNackRate (1e-6);
+  for (uint32_t i = 0; i < 10; i++)
+    {
+      entry->UpdateFaceCounter (face1, true);
+      entry->UpdateFaceCounter (face2, false);
+    }
+  Simulator::Stop (Seconds (0.15));
+  Simulator::Run ();
+  CheckRank (entry, "NACK ratio recalculation");
+  NS_TEST_ASSERT_MSG_EQ ((entry->m_faces.get<ndn::fib::i_nth> () [2].GetFace () == face1), true,
+                         "Face with NACKs should be ranked last");
+
+  entry->Invalidate ();
+  CheckRank (entry, "invalidating entry");
+
+  Simulator::Destroy ();
+}
+
 }
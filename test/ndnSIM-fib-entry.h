@@ -24,11 +24,16 @@
 #include "ns3/test.h"
 #include "ns3/ptr.h"
 
+#include <string>
+
 namespace ns3 {
 
 namespace ndn {
 class Fib;
 class Pit;
+namespace fib {
+class Entry;
+}
 }
 
 class FibEntryTest : public TestCase
@@ -43,6 +48,21 @@ private:
   virtual void DoRun ();
 };
 
+class FibEntryRankTest : public TestCase
+{
+public:
+  FibEntryRankTest ()
+    : TestCase ("FIB entry next hop ranking test")
+  {
+  }
+
+private:
+  virtual void DoRun ();
+
+  void CheckRank (Ptr<ndn::fib::Entry> entry, const std::string &step);
+  void CheckBest (Ptr<ndn::fib::Entry> entry, uint32_t faceId, const std::string &step);
+};
+
 }
 
 #endif // NDNSIM_TEST_FIB_ENTRY_H
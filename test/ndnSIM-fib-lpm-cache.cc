@@ -0,0 +1,99 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2013 University of California, Los Angeles
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Alexander Afanasyev <alexander.afanasyev@ucla.edu>
+ */
+
+#include "ndnSIM-fib-lpm-cache.h"
+#include "ns3/core-module.h"
+#include "ns3/ndnSIM-module.h"
+#include "ns3/point-to-point-module.h"
+
+#include "ns3/ndn-fib-entry.h"
+
+NS_LOG_COMPONENT_DEFINE ("ndn.FibLpmCacheTest");
+
+namespace ns3
+{
+
+static Ptr<ndn::fib::Entry>
+Lookup (Ptr<ndn::Fib> fib, const std::string &prefix, uint32_t seq)
+{
+  Ptr<ndn::Name> name = Create<ndn::Name> (prefix);
+  (*name) (seq);
+
+  ndn::Interest interest;
+  interest.SetName (name);
+  return fib->LongestPrefixMatch (interest);
+}
+
+static uint64_t
+GetCounter (Ptr<ndn::Fib> fib, const std::string &counter)
+{
+  UintegerValue value;
+  fib->GetAttribute (counter, value);
+  return value.Get ();
+}
+
+void
+FibLpmCacheTest::DoRun ()
+{
+  Ptr<Node> node = CreateObject<Node> ();
+  Ptr<Node> neighbor = CreateObject<Node> ();
+  PointToPointHelper p2p;
+  p2p.Install (node, neighbor);
+
+  ndn::StackHelper ndn;
+  ndn.Install (node);
+
+  Ptr<ndn::Face> face = node->GetObject<ndn::L3Protocol> ()->GetFace (0);
+  Ptr<ndn::Fib> fib = node->GetObject<ndn::Fib> ();
+  Ptr<ndn::fib::Entry> prefixEntry = fib->Add (ndn::Name ("/prefix"), face, 0);
+
+  // /prefix/<seq> names should share the cache record of /prefix
+  for (uint32_t seq = 0; seq < 100; seq++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (Lookup (fib, "/prefix", seq), prefixEntry, "Wrong LPM result for /prefix/" << seq);
+    }
+  NS_TEST_ASSERT_MSG_EQ (GetCounter (fib, "LpmCacheMisses"), 1, "Only the first /prefix/<seq> lookup should miss");
+  NS_TEST_ASSERT_MSG_EQ (GetCounter (fib, "LpmCacheHits"), 99, "All other /prefix/<seq> lookups should hit");
+
+  // longer prefix changes the key length, cached results should not be reused
+  Ptr<ndn::fib::Entry> seqEntry = fib->Add (ndn::Name ("/prefix/5"), face, 0);
+  NS_TEST_ASSERT_MSG_EQ (Lookup (fib, "/prefix", 5), seqEntry, "Lookup should find the longer prefix");
+  NS_TEST_ASSERT_MSG_EQ (Lookup (fib, "/prefix", 6), prefixEntry, "Lookup should find /prefix");
+  NS_TEST_ASSERT_MSG_EQ (Lookup (fib, "/prefix", 5), seqEntry, "Cached lookup should find the longer prefix");
+  NS_TEST_ASSERT_MSG_EQ (GetCounter (fib, "LpmCacheMisses"), 3, "Wrong number of misses after FIB update");
+  NS_TEST_ASSERT_MSG_EQ (GetCounter (fib, "LpmCacheHits"), 100, "Wrong number of hits after FIB update");
+
+  // cache is bypassed while FIB contains prefixes longer than LpmCacheComponents
+  fib->SetAttribute ("LpmCacheComponents", UintegerValue (1));
+  for (uint32_t seq = 0; seq < 10; seq++)
+    Lookup (fib, "/prefix", seq);
+  NS_TEST_ASSERT_MSG_EQ (GetCounter (fib, "LpmCacheMisses") + GetCounter (fib, "LpmCacheHits"), 103,
+                         "Cache should be bypassed");
+
+  fib->Remove (Create<ndn::Name> ("/prefix/5"));
+  NS_TEST_ASSERT_MSG_EQ (Lookup (fib, "/prefix", 5), prefixEntry, "Lookup should find /prefix after removal");
+  NS_TEST_ASSERT_MSG_EQ (Lookup (fib, "/prefix", 6), prefixEntry, "Lookup should find /prefix after removal");
+  NS_TEST_ASSERT_MSG_EQ (GetCounter (fib, "LpmCacheMisses"), 4, "Cache should be used again after removal");
+  NS_TEST_ASSERT_MSG_EQ (GetCounter (fib, "LpmCacheHits"), 101, "Cache should be used again after removal");
+
+  Simulator::Destroy ();
+}
+
+}
@@ -0,0 +1,110 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2013 University of California, Los Angeles
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Alexander Afanasyev <alexander.afanasyev@ucla.edu>
+ */
+
+#include "ndnSIM-fib-next-hop-sampler.h"
+#include "ns3/core-module.h"
+#include "ns3/ndnSIM-module.h"
+#include "ns3/point-to-point-module.h"
+
+#include "ns3/ndn-fib-entry.h"
+#include "ns3/ndnSIM/model/fib/ndn-fib-next-hop-sampler.h"
+
+#include <vector>
+
+NS_LOG_COMPONENT_DEFINE ("ndn.NextHopSamplerTest");
+
+namespace ns3
+{
+
+void
+NextHopSamplerTest::DoRun ()
+{
+  Ptr<Node> node = CreateObject<Node> ();
+  NodeContainer neighbors;
+  neighbors.Create (5);
+
+  PointToPointHelper p2p;
+  for (uint32_t i = 0; i < neighbors.GetN (); i++)
+    p2p.Install (node, neighbors.Get (i));
+
+  ndn::StackHelper ndn;
+  ndn.Install (node);
+
+  Ptr<ndn::L3Protocol> l3 = node->GetObject<ndn::L3Protocol> ();
+  Ptr<ndn::fib::Entry> entry = node->GetObject<ndn::Fib> ()->Add (ndn::Name ("/prefix"), l3->GetFace (0), 10);
+  for (uint32_t i = 1; i < 5; i++)
+    entry->AddOrUpdateRoutingMetric (l3->GetFace (i), 10 + i);
+
+  Ptr<ndn::fib::NextHopSampler> sampler = ndn::fib::NextHopSampler::Get (entry);
+  NS_TEST_ASSERT_MSG_EQ (ndn::fib::NextHopSampler::Get (entry), sampler, "Sampler should be aggregated to the FIB entry");
+  NS_TEST_ASSERT_MSG_EQ (sampler->IsValid (*entry), false, "Table should not be built yet");
+
+  // weights of the next hops in rank order (including a zero weight and weights that are not "round" in the table)
+  double weightArray[] = { 0.5, 0.0, 2.5, 1.0, 6.0 };
+  std::vector<double> weights (weightArray, weightArray + 5);
+  sampler->Build (*entry, weights);
+  NS_TEST_ASSERT_MSG_EQ (sampler->IsValid (*entry), true, "Table should be valid after Build");
+
+  // sample on a regular grid over [0, 1): the alias table is exact, so frequency of each next hop
+  // should match its normalized weight up to the grid resolution
+  const uint32_t points = 100000;
+  std::vector<uint32_t> counts (5, 0);
+  for (uint32_t i = 0; i < points; i++)
+    {
+      uint32_t rank = sampler->Sample ((i + 0.5) / points);
+      NS_TEST_ASSERT_MSG_EQ ((rank < 5), true, "Sampled rank is out of range");
+      counts[rank] ++;
+    }
+
+  for (uint32_t rank = 0; rank < 5; rank++)
+    {
+      NS_TEST_ASSERT_MSG_EQ_TOL (counts[rank] * 1.0 / points, weights[rank] / 10.0, 0.001,
+                                 "Wrong frequency of next hop " << rank);
+    }
+  NS_TEST_ASSERT_MSG_EQ (counts[1], 0, "Next hop with zero weight should never be selected");
+
+  // all zero weights: next hops are selected uniformly
+  std::vector<double> zeros (5, 0.0);
+  sampler->Build (*entry, zeros);
+  counts.assign (5, 0);
+  for (uint32_t i = 0; i < points; i++)
+    counts[sampler->Sample ((i + 0.5) / points)] ++;
+  for (uint32_t rank = 0; rank < 5; rank++)
+    {
+      NS_TEST_ASSERT_MSG_EQ_TOL (counts[rank] * 1.0 / points, 0.2, 0.001, "Selection should be uniform when all weights are zero");
+    }
+
+  // edges of the uniform range
+  NS_TEST_ASSERT_MSG_EQ (sampler->Sample (0.0), 0, "Wrong rank for the lowest value");
+  NS_TEST_ASSERT_MSG_EQ (sampler->Sample (0.999999), 4, "Wrong rank for the highest value");
+
+  // table should be rebuilt when next hops of the entry change
+  entry->AddOrUpdateRoutingMetric (l3->GetFace (1), 1);
+  NS_TEST_ASSERT_MSG_EQ (sampler->IsValid (*entry), false, "Table should be invalid after change of next hops");
+
+  sampler->Build (*entry, weights);
+  NS_TEST_ASSERT_MSG_EQ (sampler->IsValid (*entry), true, "Table should be valid after Build");
+  sampler->Invalidate ();
+  NS_TEST_ASSERT_MSG_EQ (sampler->IsValid (*entry), false, "Table should be invalid after Invalidate");
+
+  Simulator::Destroy ();
+}
+
+}
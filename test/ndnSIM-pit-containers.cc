@@ -0,0 +1,130 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2013 University of California, Los Angeles
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Alexander Afanasyev <alexander.afanasyev@ucla.edu>
+ */
+
+#include "ndnSIM-pit-containers.h"
+#include "ns3/core-module.h"
+#include "ns3/ndnSIM-module.h"
+#include "ns3/point-to-point-module.h"
+
+#include "ns3/ndn-pit-entry.h"
+
+#include <set>
+
+NS_LOG_COMPONENT_DEFINE ("ndn.PitContainersTest");
+
+namespace ns3
+{
+
+void
+PitContainersTest::CheckFaceRecords ()
+{
+  Ptr<Node> node = CreateObject<Node> ();
+  NodeContainer neighbors;
+  neighbors.Create (5);
+
+  PointToPointHelper p2p;
+  for (uint32_t i = 0; i < neighbors.GetN (); i++)
+    p2p.Install (node, neighbors.Get (i));
+
+  ndn::StackHelper ndn;
+  ndn.Install (node);
+
+  Ptr<ndn::L3Protocol> l3 = node->GetObject<ndn::L3Protocol> ();
+  NS_TEST_ASSERT_MSG_EQ (l3->GetNFaces (), 5, "There should be 5 faces");
+
+  // inline capacity is 2, insert faces in reverse order to force both spill to heap and reordering
+  ndn::pit::Entry::in_container records;
+  for (uint32_t i = l3->GetNFaces (); i > 0; i--)
+    {
+      NS_TEST_ASSERT_MSG_EQ (records.insert (ndn::pit::IncomingFace (l3->GetFace (i - 1))).second, true,
+                             "New face should be inserted");
+    }
+  NS_TEST_ASSERT_MSG_EQ (records.insert (ndn::pit::IncomingFace (l3->GetFace (3))).second, false,
+                         "Duplicate face should not be inserted");
+  NS_TEST_ASSERT_MSG_EQ (records.size (), 5, "All faces should be in the container");
+
+  uint32_t prevId = 0;
+  for (ndn::pit::Entry::in_iterator record = records.begin (); record != records.end (); record++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (record == records.begin () || prevId < record->m_face->GetId (), true,
+                             "Records should be ordered by face id");
+      prevId = record->m_face->GetId ();
+    }
+
+  // copy of the spilled container should be independent
+  ndn::pit::Entry::in_container copy (records);
+  records.erase (l3->GetFace (2));
+  NS_TEST_ASSERT_MSG_EQ (records.size (), 4, "Face should be removed");
+  NS_TEST_ASSERT_MSG_EQ (records.find (l3->GetFace (2)) == records.end (), true, "Removed face should not be found");
+  NS_TEST_ASSERT_MSG_EQ (records.find (l3->GetFace (4)) != records.end (), true, "Other faces should be found");
+  NS_TEST_ASSERT_MSG_EQ (copy.size (), 5, "Copy should not be affected");
+  NS_TEST_ASSERT_MSG_EQ (copy.find (l3->GetFace (2)) != copy.end (), true, "Copy should not be affected");
+
+  records.clear ();
+  NS_TEST_ASSERT_MSG_EQ (records.empty (), true, "Container should be empty");
+  NS_TEST_ASSERT_MSG_EQ (records.insert (ndn::pit::IncomingFace (l3->GetFace (0))).second, true,
+                         "Container should be reusable after clear");
+}
+
+void
+PitContainersTest::CheckNonces ()
+{
+  // default container should behave exactly as std::set, including after spill to heap
+  ndn::pit::Entry::nonce_container nonces;
+  std::set<uint32_t> reference;
+
+  UniformVariable rand (0, 100);
+  for (uint32_t i = 0; i < 500; i++)
+    {
+      uint32_t nonce = rand.GetInteger (0, 100);
+      nonces.insert (nonce);
+      reference.insert (nonce);
+    }
+
+  NS_TEST_ASSERT_MSG_EQ (nonces.size (), reference.size (), "Size should be equal to the number of distinct nonces");
+  for (uint32_t nonce = 0; nonce <= 100; nonce++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (nonces.count (nonce), reference.count (nonce), "Nonce " << nonce << " should be " <<
+                             (reference.count (nonce) ? "seen" : "unseen"));
+    }
+
+  // bounded mode: the last nonces are exact, evicted ones are still seen (no false negatives)
+  ndn::pit::Entry::nonce_container bounded;
+  bounded.SetBounded (true);
+  for (uint32_t nonce = 1; nonce <= 10; nonce++)
+    bounded.insert (nonce);
+
+  NS_TEST_ASSERT_MSG_EQ (bounded.size (), 4, "Only nonces in the ring should be counted");
+  for (uint32_t nonce = 1; nonce <= 10; nonce++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (bounded.count (nonce), 1, "Nonce " << nonce << " should be seen");
+    }
+}
+
+void
+PitContainersTest::DoRun ()
+{
+  CheckFaceRecords ();
+  CheckNonces ();
+
+  Simulator::Destroy ();
+}
+
+}
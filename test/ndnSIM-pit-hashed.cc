@@ -0,0 +1,188 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2013 University of California, Los Angeles
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Alexander Afanasyev <alexander.afanasyev@ucla.edu>
+ */
+
+#include "ndnSIM-pit-hashed.h"
+#include "ns3/core-module.h"
+#include "ns3/ndnSIM-module.h"
+#include "ns3/point-to-point-module.h"
+
+#include "ns3/ndn-pit.h"
+#include "ns3/ndn-pit-entry.h"
+
+#include <set>
+#include <vector>
+#include <string>
+
+NS_LOG_COMPONENT_DEFINE ("ndn.PitHashedTest");
+
+namespace ns3
+{
+
+static UniformVariable g_rand;
+
+// names of up to maxLength components from a small alphabet, so that names share prefixes
+static Ptr<ndn::Name>
+RandomName (uint32_t maxLength)
+{
+  Ptr<ndn::Name> name = Create<ndn::Name> ();
+  uint32_t length = g_rand.GetInteger (0, maxLength);
+  for (uint32_t i = 0; i < length; i++)
+    {
+      name->Add (std::string (1, 'a' + g_rand.GetInteger (0, 3)));
+    }
+  return name;
+}
+
+static std::set<ndn::Name>
+Prefixes (const std::vector< Ptr<ndn::pit::Entry> > &entries)
+{
+  std::set<ndn::Name> prefixes;
+  for (std::vector< Ptr<ndn::pit::Entry> >::const_iterator entry = entries.begin (); entry != entries.end (); entry++)
+    {
+      prefixes.insert ((*entry)->GetPrefix ());
+    }
+  return prefixes;
+}
+
+void
+PitHashedTest::CheckEquivalence (Ptr<ndn::Pit> persistent, Ptr<ndn::Pit> hashed)
+{
+  NS_TEST_ASSERT_MSG_EQ (hashed->GetSize (), persistent->GetSize (), "PITs should have the same number of entries");
+
+  uint32_t iterated = 0;
+  for (Ptr<ndn::pit::Entry> entry = hashed->Begin (); entry != hashed->End (); entry = hashed->Next (entry))
+    {
+      iterated ++;
+    }
+  NS_TEST_ASSERT_MSG_EQ (iterated, hashed->GetSize (), "Iteration should visit all entries");
+
+  for (uint32_t i = 0; i < 300; i++)
+    {
+      ndn::ContentObject data;
+      data.SetName (RandomName (5));
+
+      Ptr<ndn::pit::Entry> p = persistent->Lookup (data);
+      Ptr<ndn::pit::Entry> h = hashed->Lookup (data);
+      NS_TEST_ASSERT_MSG_EQ ((p == 0), (h == 0), "Both PITs should (or should not) match " << data.GetName ());
+      if (p != 0 && h != 0)
+        {
+          NS_TEST_ASSERT_MSG_EQ (h->GetPrefix (), p->GetPrefix (), "Longest prefix match should be the same");
+        }
+
+      std::vector< Ptr<ndn::pit::Entry> > pAll, hAll;
+      persistent->LookupAll (data, pAll);
+      hashed->LookupAll (data, hAll);
+      NS_TEST_ASSERT_MSG_EQ (hAll.size (), pAll.size (), "All prefix matches should be the same for " << data.GetName ());
+      NS_TEST_ASSERT_MSG_EQ ((Prefixes (hAll) == Prefixes (pAll)), true, "All prefix matches should be the same for " << data.GetName ());
+
+      Ptr<const ndn::Name> name = data.GetNamePtr ();
+      Ptr<ndn::pit::Entry> pFound = persistent->Find (*name);
+      Ptr<ndn::pit::Entry> hFound = hashed->Find (*name);
+      NS_TEST_ASSERT_MSG_EQ ((pFound == 0), (hFound == 0), "Exact match should be the same for " << *name);
+    }
+}
+
+void
+PitHashedTest::CheckAllFound (Ptr<ndn::Pit> hashed)
+{
+  // every entry should be reachable from its home slot, i.e., backward shift deletion did not break probe sequences
+  for (Ptr<ndn::pit::Entry> entry = hashed->Begin (); entry != hashed->End (); entry = hashed->Next (entry))
+    {
+      NS_TEST_ASSERT_MSG_EQ ((hashed->Find (entry->GetPrefix ()) == entry), true,
+                             "Entry " << entry->GetPrefix () << " should be found");
+    }
+}
+
+void
+PitHashedTest::DoRun ()
+{
+  NodeContainer nodes;
+  nodes.Create (3);
+
+  PointToPointHelper p2p;
+  p2p.Install (nodes.Get (0), nodes.Get (2));
+  p2p.Install (nodes.Get (1), nodes.Get (2));
+
+  ndn::StackHelper ndn;
+  ndn.SetPit ("ns3::ndn::pit::Persistent");
+  ndn.Install (nodes.Get (0));
+  ndn.SetPit ("ns3::ndn::pit::Hashed");
+  ndn.Install (nodes.Get (1));
+
+  ndn::StackHelper::AddRoute (nodes.Get (0), "/", 0, 0);
+  ndn::StackHelper::AddRoute (nodes.Get (1), "/", 0, 0);
+
+  Ptr<ndn::Pit> persistent = nodes.Get (0)->GetObject<ndn::Pit> ();
+  Ptr<ndn::Pit> hashed = nodes.Get (1)->GetObject<ndn::Pit> ();
+  Ptr<ndn::Face> persistentFace = nodes.Get (0)->GetObject<ndn::L3Protocol> ()->GetFace (0);
+  Ptr<ndn::Face> hashedFace = nodes.Get (1)->GetObject<ndn::L3Protocol> ()->GetFace (0);
+
+  // enough entries to grow the table several times, so that probe sequences wrap around the end of the table
+  for (uint32_t i = 0; i < 1000; i++)
+    {
+      Ptr<ndn::Interest> interest = Create<ndn::Interest> ();
+      interest->SetName (RandomName (5));
+      interest->SetNonce (i);
+      interest->SetInterestLifetime (Seconds (100));
+
+      Ptr<ndn::pit::Entry> p = persistent->Lookup (*interest);
+      if (p == 0)
+        p = persistent->Create (interest);
+      Ptr<ndn::pit::Entry> h = hashed->Lookup (*interest);
+      if (h == 0)
+        h = hashed->Create (interest);
+
+      NS_TEST_ASSERT_MSG_EQ ((p != 0 && h != 0), true, "Entries should be created");
+
+      // some entries are left without incoming faces, they should not match Data
+      if (i % 5 != 0)
+        {
+          p->AddIncoming (persistentFace);
+          h->AddIncoming (hashedFace);
+        }
+    }
+
+  CheckAllFound (hashed);
+  CheckEquivalence (persistent, hashed);
+
+  // erase random entries one by one
+  while (hashed->GetSize () > 10)
+    {
+      Ptr<ndn::Name> name = RandomName (5);
+      Ptr<ndn::pit::Entry> h = hashed->Find (*name);
+      if (h == 0)
+        continue;
+
+      Ptr<ndn::pit::Entry> p = persistent->Find (*name);
+      NS_TEST_ASSERT_MSG_EQ ((p != 0), true, "Entry " << *name << " should exist in both PITs");
+
+      hashed->MarkErased (h);
+      persistent->MarkErased (p);
+
+      NS_TEST_ASSERT_MSG_EQ ((hashed->Find (*name) == 0), true, "Erased entry should not be found");
+      CheckAllFound (hashed);
+    }
+
+  CheckEquivalence (persistent, hashed);
+
+  Simulator::Destroy ();
+}
+
+}
@@ -0,0 +1,91 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2013 University of California, Los Angeles
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Alexander Afanasyev <alexander.afanasyev@ucla.edu>
+ */
+
+#include "ndnSIM-ring-buffer.h"
+#include "ns3/core-module.h"
+
+#include "ns3/ndnSIM/utils/ndn-ring-buffer.h"
+
+NS_LOG_COMPONENT_DEFINE ("ndn.RingBufferTest");
+
+namespace ns3
+{
+
+void
+RingBufferTest::DoRun ()
+{
+  ndn::RingBuffer<uint32_t> buffer;
+  NS_TEST_ASSERT_MSG_EQ (buffer.capacity (), 0, "Buffer should not be allocated");
+  NS_TEST_ASSERT_MSG_EQ (buffer.full (), true, "Buffer without capacity should be full");
+
+  buffer.Reserve (4);
+  NS_TEST_ASSERT_MSG_EQ (buffer.capacity (), 4, "Wrong capacity");
+  NS_TEST_ASSERT_MSG_EQ (buffer.empty (), true, "Buffer should be empty");
+
+  // 0 1 2, then 0 1 are removed and 3 4 5 are added: the queue wraps around the end of the buffer
+  uint32_t next = 0;
+  for (; next < 3; next++)
+    buffer.push_back (next);
+  buffer.pop_front ();
+  buffer.pop_front ();
+  for (; next < 6; next++)
+    buffer.push_back (next);
+
+  NS_TEST_ASSERT_MSG_EQ (buffer.full (), true, "Buffer should be full");
+  NS_TEST_ASSERT_MSG_EQ (buffer.size (), 4, "Wrong size");
+  NS_TEST_ASSERT_MSG_EQ (buffer.front (), 2, "Wrong front element");
+  for (uint32_t i = 0; i < buffer.size (); i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (buffer[i], 2 + i, "Wrong order of elements in the wrapped buffer");
+    }
+
+  // growing the wrapped buffer should keep the order of elements
+  buffer.Reserve (6);
+  NS_TEST_ASSERT_MSG_EQ (buffer.capacity (), 6, "Wrong capacity");
+  NS_TEST_ASSERT_MSG_EQ (buffer.size (), 4, "Elements should be kept");
+  for (; next < 8; next++)
+    buffer.push_back (next);
+  NS_TEST_ASSERT_MSG_EQ (buffer.full (), true, "Buffer should be full");
+
+  for (uint32_t expected = 2; expected < 8; expected++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (buffer.front (), expected, "Wrong order of elements after Reserve");
+      buffer.pop_front ();
+    }
+  NS_TEST_ASSERT_MSG_EQ (buffer.empty (), true, "Buffer should be empty");
+
+  // the queue can go around the buffer many times
+  for (uint32_t i = 0; i < 20; i++)
+    {
+      buffer.push_back (i);
+      buffer.push_back (i + 100);
+      NS_TEST_ASSERT_MSG_EQ (buffer.front (), i, "Wrong front element");
+      buffer.pop_front ();
+      NS_TEST_ASSERT_MSG_EQ (buffer.front (), i + 100, "Wrong front element");
+      buffer.pop_front ();
+    }
+
+  buffer.push_back (1);
+  buffer.clear ();
+  NS_TEST_ASSERT_MSG_EQ (buffer.empty (), true, "Buffer should be empty after clear");
+  NS_TEST_ASSERT_MSG_EQ (buffer.capacity (), 6, "Clear should not release memory");
+}
+
+}
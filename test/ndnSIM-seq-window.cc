@@ -0,0 +1,111 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2013 University of California, Los Angeles
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Alexander Afanasyev <alexander.afanasyev@ucla.edu>
+ */
+
+#include "ndnSIM-seq-window.h"
+#include "ns3/core-module.h"
+
+#include "ns3/ndnSIM/utils/ndn-seq-window.h"
+
+NS_LOG_COMPONENT_DEFINE ("ndn.SeqWindowTest");
+
+namespace ns3
+{
+
+void
+SeqWindowTest::DoRun ()
+{
+  // sequence numbers 6, 14, 22, 7 collide in the table of capacity 8: 6, 14, 22 occupy slots 6, 7, 0
+  // (wrapping around the end of the table), and 7 is pushed to slot 1
+  ndn::SeqWindow window (8);
+  window.Sent (6, Seconds (1.0));
+  window.Sent (14, Seconds (2.0));
+  window.Sent (22, Seconds (3.0));
+  window.Sent (7, Seconds (4.0));
+  NS_TEST_ASSERT_MSG_EQ (window.size (), 4, "Wrong size");
+  NS_TEST_ASSERT_MSG_EQ (window.Find (22), 0, "Record should wrap around the end of the table");
+  NS_TEST_ASSERT_MSG_EQ (window.Find (7), 1, "Record should be placed after the colliding records");
+
+  // erase of the first record in the chain should shift all other records back, across the wrap
+  window.Erase (6);
+  NS_TEST_ASSERT_MSG_EQ (window.size (), 3, "Wrong size after Erase");
+  NS_TEST_ASSERT_MSG_EQ (window.Find (6), ndn::SeqWindow::NONE, "Erased record should not be found");
+  NS_TEST_ASSERT_MSG_EQ (window.Find (14), 6, "Record should be shifted to its home slot");
+  NS_TEST_ASSERT_MSG_EQ (window.Find (22), 7, "Record should be shifted back across the wrap");
+  NS_TEST_ASSERT_MSG_EQ (window.Find (7), 0, "Record should be shifted back across the wrap");
+  NS_TEST_ASSERT_MSG_EQ (window.GetLastSendTime (window.Find (22)), Seconds (3.0), "Shifted record should keep its data");
+
+  // shifted records should stay in the outstanding list in the same order
+  NS_TEST_ASSERT_MSG_EQ (window.GetOutstandingCount (), 3, "Wrong number of outstanding records");
+  uint32_t expectedOrder[] = { 14, 22, 7 };
+  for (uint32_t i = 0; i < 3; i++)
+    {
+      uint32_t seq = window.GetSeq (window.GetOldestOutstanding ());
+      NS_TEST_ASSERT_MSG_EQ (seq, expectedOrder[i], "Wrong order of outstanding records after Erase");
+      window.StopTimer (seq);
+    }
+  NS_TEST_ASSERT_MSG_EQ (window.GetOldestOutstanding (), ndn::SeqWindow::NONE, "Nothing should be outstanding");
+  NS_TEST_ASSERT_MSG_EQ (window.size (), 3, "StopTimer should keep the records");
+
+  // Sent on an outstanding sequence number restarts its timer and keeps the time of the first transmission
+  window.Sent (14, Seconds (5.0));
+  window.Sent (22, Seconds (6.0));
+  window.Sent (14, Seconds (7.0));
+  NS_TEST_ASSERT_MSG_EQ (window.GetOutstandingCount (), 2, "Retransmission should not add outstanding records");
+  NS_TEST_ASSERT_MSG_EQ (window.GetSeq (window.GetOldestOutstanding ()), 22, "Retransmitted record should be moved to the end of the list");
+  uint32_t slot = window.Find (14);
+  NS_TEST_ASSERT_MSG_EQ (window.GetTransmissionCount (slot), 3, "Wrong number of transmissions");
+  NS_TEST_ASSERT_MSG_EQ (window.GetFirstSendTime (slot), Seconds (2.0), "First transmission time should be kept");
+  NS_TEST_ASSERT_MSG_EQ (window.GetLastSendTime (slot), Seconds (7.0), "Wrong last transmission time");
+
+  // Grow should keep the records and the timer order of outstanding records
+  ndn::SeqWindow growing (2);
+  for (uint32_t seq = 0; seq < 32; seq++)
+    {
+      growing.Sent (seq, Seconds (seq));
+      if (seq % 3 == 0)
+        growing.StopTimer (seq);
+    }
+  // restart timers of a few records in the middle, so timer order differs from sequence order
+  for (uint32_t seq = 1; seq < 32; seq += 8)
+    growing.Sent (seq, Seconds (100 + seq));
+  for (uint32_t seq = 32; seq < 64; seq++)
+    growing.Sent (seq, Seconds (200 + seq));
+
+  NS_TEST_ASSERT_MSG_EQ (growing.size (), 64, "Records should be kept by Grow");
+  for (uint32_t seq = 0; seq < 32; seq++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (growing.Find (seq) != ndn::SeqWindow::NONE, true, "Record should be kept by Grow");
+      NS_TEST_ASSERT_MSG_EQ (growing.GetFirstSendTime (growing.Find (seq)), Seconds (seq), "Record data should be kept by Grow");
+      NS_TEST_ASSERT_MSG_EQ (growing.IsOutstanding (seq), seq % 3 != 0 || seq % 8 == 1, "Wrong state after Grow");
+    }
+
+  Time last = Seconds (0);
+  uint32_t outstanding = growing.GetOutstandingCount ();
+  for (uint32_t i = 0; i < outstanding; i++)
+    {
+      uint32_t oldest = growing.GetOldestOutstanding ();
+      NS_TEST_ASSERT_MSG_EQ (growing.GetLastSendTime (oldest) >= last, true, "Outstanding records should be ordered by timer start");
+      last = growing.GetLastSendTime (oldest);
+      growing.StopTimer (growing.GetSeq (oldest));
+    }
+  NS_TEST_ASSERT_MSG_EQ (growing.GetOutstandingCount (), 0, "Nothing should be outstanding");
+}
+
+}
@@ -24,6 +24,13 @@
 #include "ndnSIM-serialization.h"
 #include "ndnSIM-pit.h"
 #include "ndnSIM-fib-entry.h"
+#include "ndnSIM-fib-next-hop-sampler.h"
+#include "ndnSIM-fib-lpm-cache.h"
+#include "ndnSIM-pit-containers.h"
+#include "ndnSIM-pit-hashed.h"
+#include "ndnSIM-ring-buffer.h"
+#include "ndnSIM-seq-window.h"
+#include "ndnSIM-zipf-mandelbrot-sampler.h"
 
 namespace ns3
 {
@@ -39,6 +46,14 @@ public:
     AddTestCase (new InterestSerializationTest ());
     AddTestCase (new ContentObjectSerializationTest ());
     AddTestCase (new FibEntryTest ());
+    AddTestCase (new FibEntryRankTest ());
+    AddTestCase (new NextHopSamplerTest ());
+    AddTestCase (new FibLpmCacheTest ());
+    AddTestCase (new PitContainersTest ());
+    AddTestCase (new PitHashedTest ());
+    AddTestCase (new RingBufferTest ());
+    AddTestCase (new SeqWindowTest ());
+    AddTestCase (new ZipfMandelbrotSamplerTest ());
     // AddTestCase (new PitTest ());
   }
 };
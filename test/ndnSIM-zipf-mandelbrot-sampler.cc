@@ -0,0 +1,92 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2013 University of California, Los Angeles
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Alexander Afanasyev <alexander.afanasyev@ucla.edu>
+ */
+
+#include "ndnSIM-zipf-mandelbrot-sampler.h"
+#include "ns3/core-module.h"
+
+#include "ns3/ndnSIM/utils/ndn-zipf-mandelbrot-sampler.h"
+
+#include <cmath>
+#include <vector>
+
+NS_LOG_COMPONENT_DEFINE ("ndn.ZipfMandelbrotSamplerTest");
+
+namespace ns3
+{
+
+void
+ZipfMandelbrotSamplerTest::DoRun ()
+{
+  uint32_t contents[] = { 1, 5, 100, 1000 };
+  double qs[] = { 0.0, 2.0, 0.0, 0.7 };
+  double ss[] = { 0.7, 0.0, 0.75, 1.2 };
+
+  for (uint32_t test = 0; test < 4; test++)
+    {
+      uint32_t n = contents[test];
+      ndn::ZipfMandelbrotSampler sampler (n, qs[test], ss[test]);
+      NS_TEST_ASSERT_MSG_EQ (sampler.GetNumberOfContents (), n, "Wrong number of contents");
+
+      // cumulative probability table, as previously built by Consumer for ZIPF_MANDELBROT mode
+      std::vector<double> pcum (n + 1);
+      pcum[0] = 0.0;
+      for (uint32_t i = 1; i <= n; i++)
+        pcum[i] = pcum[i-1] + 1.0 / std::pow (i + qs[test], ss[test]);
+      for (uint32_t i = 1; i <= n; i++)
+        pcum[i] = pcum[i] / pcum[n];
+
+      // sample on a regular grid over [0, 1).  The alias table maps each bin to at most two ranks,
+      // so count of each rank can differ from the exact value only by one point per bin boundary
+      uint32_t points = 1000 * n;
+      std::vector<uint32_t> counts (n + 1, 0);
+      for (uint32_t i = 0; i < points; i++)
+        {
+          uint32_t rank = sampler.Sample ((i + 0.5) / points);
+          NS_TEST_ASSERT_MSG_EQ ((rank >= 1 && rank <= n), true, "Sampled rank is out of range");
+          counts[rank] ++;
+        }
+
+      double distance = 0.0;
+      for (uint32_t rank = 1; rank <= n; rank++)
+        {
+          double expected = pcum[rank] - pcum[rank-1];
+          double frequency = counts[rank] * 1.0 / points;
+          NS_TEST_ASSERT_MSG_EQ_TOL (frequency, expected, n * 1.0 / points,
+                                     "Wrong frequency of rank " << rank << " (N=" << n << ")");
+          distance += std::fabs (frequency - expected);
+        }
+      NS_TEST_ASSERT_MSG_EQ ((distance <= 2.0 * n / points), true,
+                             "Sampled distribution differs from the cumulative table (N=" << n << ")");
+
+      NS_TEST_ASSERT_MSG_EQ (sampler.Sample (0.0) >= 1, true, "Wrong rank for the lowest value");
+      NS_TEST_ASSERT_MSG_EQ (sampler.Sample (1.0) <= n, true, "Wrong rank for uniform value 1.0");
+    }
+
+  // samplers with the same parameters are shared
+  boost::shared_ptr<const ndn::ZipfMandelbrotSampler> sampler1 = ndn::ZipfMandelbrotSampler::Get (100, 0.0, 0.75);
+  boost::shared_ptr<const ndn::ZipfMandelbrotSampler> sampler2 = ndn::ZipfMandelbrotSampler::Get (100, 0.0, 0.75);
+  boost::shared_ptr<const ndn::ZipfMandelbrotSampler> sampler3 = ndn::ZipfMandelbrotSampler::Get (100, 0.5, 0.75);
+  NS_TEST_ASSERT_MSG_EQ ((sampler1 == sampler2), true, "Samplers with the same parameters should be shared");
+  NS_TEST_ASSERT_MSG_EQ ((sampler1 != sampler3), true, "Samplers with different parameters should not be shared");
+  NS_TEST_ASSERT_MSG_EQ (sampler3->GetQ (), 0.5, "Wrong q");
+  NS_TEST_ASSERT_MSG_EQ (sampler3->GetS (), 0.75, "Wrong s");
+}
+
+}
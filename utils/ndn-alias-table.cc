@@ -0,0 +1,83 @@
+/* -*- Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2013 University of California, Los Angeles
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Alexander Afanasyev <alexander.afanasyev@ucla.edu>
+ */
+
+#include "ndn-alias-table.h"
+
+namespace ns3 {
+namespace ndn {
+
+void
+AliasTable::Build (const std::vector<double> &weights)
+{
+  uint32_t n = weights.size ();
+
+  m_probabilities.resize (n);
+  m_aliases.resize (n);
+  m_worklist.resize (n);
+  if (n == 0)
+    return;
+
+  double total = 0.0;
+  for (uint32_t i = 0; i < n; i++)
+    {
+      NS_ASSERT_MSG (weights[i] >= 0.0, "Weights should be non-negative");
+      total += weights[i];
+    }
+
+  // Vose's algorithm: probabilities are scaled so that the average column has probability 1.0,
+  // columns below 1.0 (small) are topped up by the columns above 1.0 (large).
+  // Both worklists are kept in a single array: small from the front, large from the back
+  uint32_t small = 0;
+  uint32_t large = n;
+  for (uint32_t i = 0; i < n; i++)
+    {
+      m_probabilities[i] = total > 0 ? weights[i] * n / total : 1.0;
+      m_aliases[i] = i;
+      if (m_probabilities[i] < 1.0)
+        m_worklist[small++] = i;
+      else
+        m_worklist[--large] = i;
+    }
+
+  uint32_t smallBegin = 0;
+  while (smallBegin < small && large < n)
+    {
+      uint32_t less = m_worklist[smallBegin++];
+      uint32_t more = m_worklist[large];
+
+      m_aliases[less] = more;
+      m_probabilities[more] -= 1.0 - m_probabilities[less];
+      if (m_probabilities[more] < 1.0)
+        {
+          // the large column becomes small; there is always space for it, as one small column has been just consumed
+          large ++;
+          m_worklist[--smallBegin] = more;
+        }
+    }
+
+  // remaining columns are full (differences are only due to rounding errors)
+  while (smallBegin < small)
+    m_probabilities[m_worklist[smallBegin++]] = 1.0;
+  while (large < n)
+    m_probabilities[m_worklist[large++]] = 1.0;
+}
+
+} // namespace ndn
+} // namespace ns3
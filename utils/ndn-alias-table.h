@@ -0,0 +1,85 @@
+/* -*- Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2013 University of California, Los Angeles
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Alexander Afanasyev <alexander.afanasyev@ucla.edu>
+ */
+
+#ifndef NDN_ALIAS_TABLE_H
+#define NDN_ALIAS_TABLE_H
+
+#include "ns3/assert.h"
+
+#include <vector>
+#include <stdint.h>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * @ingroup ndn
+ * @brief Table to sample index from a discrete distribution with Walker's alias method
+ *
+ * Table is built in O(N) using Vose's algorithm, each sample takes O(1) and uses only one uniform random value.
+ * Table can be rebuilt many times, memory is reallocated only when the number of weights grows.
+ */
+class AliasTable
+{
+public:
+  /**
+   * @brief Build table for the weights
+   * @param weights Non-negative weights of the indexes.  If all weights are zero, indexes are selected uniformly.
+   */
+  void
+  Build (const std::vector<double> &weights);
+
+  /**
+   * @brief Get index in [0, GetSize ()) for the uniformly distributed random value in [0, 1)
+   */
+  inline uint32_t
+  Sample (double uniform) const
+  {
+    NS_ASSERT_MSG (!m_probabilities.empty (), "Alias table is empty");
+
+    uint32_t n = m_probabilities.size ();
+    double column = uniform * n;
+    uint32_t i = static_cast<uint32_t> (column);
+    if (i >= n) // guard for uniform == 1.0
+      i = n - 1;
+
+    return (column - i < m_probabilities[i]) ? i : m_aliases[i];
+  }
+
+  /**
+   * @brief Get number of indexes in the table
+   */
+  uint32_t
+  GetSize () const
+  {
+    return m_probabilities.size ();
+  }
+
+private:
+  std::vector<double> m_probabilities; ///< @brief probability to select the column itself and not its alias
+  std::vector<uint32_t> m_aliases;     ///< @brief alias of the column
+
+  std::vector<uint32_t> m_worklist;    ///< @brief scratch space for Build
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // NDN_ALIAS_TABLE_H
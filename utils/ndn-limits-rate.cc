@@ -23,6 +23,7 @@
 #include "ns3/log.h"
 #include "ns3/simulator.h"
 #include "ns3/random-variable.h"
+#include "ns3/boolean.h"
 #include "ns3/ndn-face.h"
 #include "ns3/node.h"
 
@@ -46,6 +47,11 @@ LimitsRate::GetTypeId ()
                    MakeTimeAccessor (&LimitsRate::m_leakRandomizationInteral),
                    MakeTimeChecker ())
 
+    .AddAttribute ("LazyLeak", "Calculate token bucket leakage from the elapsed time when limits are checked, "
+                               "instead of leaking the bucket with periodic events",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&LimitsRate::m_lazyLeak),
+                   MakeBooleanChecker ())
     ;
   return tid;
 }
@@ -55,6 +61,12 @@ LimitsRate::NotifyNewAggregate ()
 {
   super::NotifyNewAggregate ();
 
+  if (m_lazyLeak)
+    {
+      m_lastLeak = Simulator::Now ();
+      return;
+    }
+
   if (!m_isLeakScheduled)
     {
       if (GetObject<Face> () != 0)
@@ -79,9 +91,20 @@ LimitsRate::NotifyNewAggregate ()
     }
 }
 
+void
+LimitsRate::DoDispose ()
+{
+  m_availableSlotEvent.Cancel ();
+
+  super::DoDispose ();
+}
+
 void
 LimitsRate::SetLimits (double rate, double delay)
 {
+  if (m_lazyLeak)
+    LeakElapsed (); // leak with the old rate
+
   super::SetLimits (rate, delay);
 
   // maximum allowed burst
@@ -89,6 +112,9 @@ LimitsRate::SetLimits (double rate, double delay)
 
   // amount of packets allowed every second (leak rate)
   m_bucketLeak = GetMaxRate ();
+
+  if (m_lazyLeak)
+    RescheduleAvailableSlot ();
 }
 
 
@@ -97,8 +123,14 @@ LimitsRate::UpdateCurrentLimit (double limit)
 {
   NS_ASSERT_MSG (limit >= 0.0, "Limit should be greater or equal to zero");
 
+  if (m_lazyLeak)
+    LeakElapsed (); // leak with the old rate
+
   m_bucketLeak = std::min (limit, GetMaxRate ());
   m_bucketMax  = m_bucketLeak * GetMaxDelay ();
+
+  if (m_lazyLeak)
+    RescheduleAvailableSlot ();
 }
 
 bool
@@ -106,6 +138,9 @@ LimitsRate::IsBelowLimit ()
 {
   if (!IsEnabled ()) return true;
 
+  if (m_lazyLeak)
+    LeakElapsed ();
+
   return (m_bucketMax - m_bucket >= 1.0);
 }
 
@@ -114,8 +149,14 @@ LimitsRate::BorrowLimit ()
 {
   if (!IsEnabled ()) return;
 
+  if (m_lazyLeak)
+    LeakElapsed ();
+
   NS_ASSERT_MSG (m_bucketMax - m_bucket >= 1.0, "Should not be possible, unless we IsBelowLimit was not checked correctly");
   m_bucket += 1;
+
+  if (m_lazyLeak && m_bucketMax - m_bucket < 1.0)
+    ScheduleAvailableSlot ();
 }
 
 void
@@ -156,5 +197,54 @@ LimitsRate::LeakBucket (double interval)
   Simulator::Schedule (Seconds (newInterval), &LimitsRate::LeakBucket, this, newInterval);
 }
 
+void
+LimitsRate::LeakElapsed ()
+{
+  Time now = Simulator::Now ();
+  if (now <= m_lastLeak)
+    return;
+
+  m_bucket = std::max (0.0, m_bucket - m_bucketLeak * (now - m_lastLeak).ToDouble (Time::S));
+  m_lastLeak = now;
+}
+
+void
+LimitsRate::ScheduleAvailableSlot ()
+{
+  if (!HasAvailableSlotCallback () || m_availableSlotEvent.IsRunning () || m_bucketLeak <= 0.0)
+    return;
+
+  // time when bucket leaks enough to issue one more token (leak by 1.001 to avoid rounding problems)
+  double delay = std::max (0.0, m_bucket - (m_bucketMax - 1.001)) / m_bucketLeak;
+  m_availableSlotEvent = Simulator::Schedule (Seconds (delay), &LimitsRate::AvailableSlot, this);
+}
+
+void
+LimitsRate::RescheduleAvailableSlot ()
+{
+  // either somebody is already waiting for the slot, or the bucket is full and may need to be waited for
+  if (m_availableSlotEvent.IsRunning () || m_bucketMax - m_bucket < 1.0)
+    {
+      m_availableSlotEvent.Cancel ();
+      ScheduleAvailableSlot ();
+    }
+}
+
+void
+LimitsRate::AvailableSlot ()
+{
+  LeakElapsed ();
+
+  if (m_bucketMax - m_bucket >= 1.0)
+    {
+      this->FireAvailableSlotCallback ();
+    }
+  else
+    {
+      // leak rate has been lowered after the event was scheduled
+      ScheduleAvailableSlot ();
+    }
+}
+
 } // namespace ndn
 } // namespace ns3
@@ -23,6 +23,7 @@
 
 #include "ndn-limits.h"
 #include <ns3/nstime.h>
+#include <ns3/event-id.h>
 
 namespace ns3 {
 namespace ndn {
@@ -46,6 +47,7 @@ public:
    */
   LimitsRate ()
     : m_isLeakScheduled (false)
+    , m_lazyLeak (false)
     , m_bucketMax (0)
     , m_bucketLeak (1)
     , m_bucket (0)
@@ -108,6 +110,10 @@ protected:
   void
   NotifyNewAggregate ();
 
+  // from Object
+  virtual void
+  DoDispose ();
+
 private:
   /**
    * @brief Leak bucket, assuming `interval' seconds between leakages
@@ -117,8 +123,35 @@ private:
   void
   LeakBucket (double interval);
 
+  /**
+   * @brief Leak bucket by the amount accumulated since the last call (LazyLeak mode)
+   */
+  void
+  LeakElapsed ();
+
+  /**
+   * @brief Schedule AvailableSlot at the time the next token becomes available (LazyLeak mode)
+   */
+  void
+  ScheduleAvailableSlot ();
+
+  /**
+   * @brief Recalculate time of the next available token after leak rate or bucket size has changed (LazyLeak mode)
+   */
+  void
+  RescheduleAvailableSlot ();
+
+  /**
+   * @brief Fire FireAvailableSlotCallback if token is available, otherwise schedule the check again (LazyLeak mode)
+   */
+  void
+  AvailableSlot ();
+
 private:
   bool m_isLeakScheduled;
+  bool m_lazyLeak;      ///< \brief leak bucket on demand, instead of periodic leak events
+  Time m_lastLeak;      ///< \brief time of the last leak (LazyLeak mode)
+  EventId m_availableSlotEvent; ///< \brief pending notification about available slot (LazyLeak mode)
 
   double m_bucketMax;   ///< \brief Maximum Interest allowance for this face (maximum tokens that can be issued at the same time)
   double m_bucketLeak;  ///< \brief Normalized amount that should be leaked every second (token bucket leak rate)
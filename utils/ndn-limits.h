@@ -184,6 +184,15 @@ public:
 protected:
   void
   FireAvailableSlotCallback ();
+
+  /**
+   * @brief Check if anybody is waiting for new slots (callback is set with RegisterAvailableSlotCallback)
+   */
+  bool
+  HasAvailableSlotCallback () const
+  {
+    return !m_handler.IsNull ();
+  }
   
 private:
   double m_maxRate;
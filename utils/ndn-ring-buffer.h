@@ -0,0 +1,169 @@
+/* -*- Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2013 University of California, Los Angeles
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Alexander Afanasyev <alexander.afanasyev@ucla.edu>
+ */
+
+#ifndef NDN_RING_BUFFER_H
+#define NDN_RING_BUFFER_H
+
+#include "ns3/assert.h"
+
+#include <vector>
+#include <stdint.h>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * @ingroup ndn
+ * @brief FIFO queue on top of a fixed-size circular buffer
+ *
+ * Memory is allocated only by Reserve, push_back and pop_front do not allocate.
+ */
+template<class T>
+class RingBuffer
+{
+public:
+  typedef uint32_t size_type;
+
+  RingBuffer ()
+    : m_head (0)
+    , m_size (0)
+  {
+  }
+
+  /**
+   * @brief Set capacity of the buffer (elements are kept, capacity should not be less than the number of elements)
+   */
+  void
+  Reserve (size_type capacity)
+  {
+    NS_ASSERT (capacity >= m_size);
+
+    std::vector<T> buffer (capacity, T ());
+    for (size_type i = 0; i < m_size; i++)
+      buffer[i] = m_buffer[Index (i)];
+
+    m_buffer.swap (buffer);
+    m_head = 0;
+  }
+
+  size_type
+  capacity () const
+  {
+    return m_buffer.size ();
+  }
+
+  size_type
+  size () const
+  {
+    return m_size;
+  }
+
+  bool
+  empty () const
+  {
+    return m_size == 0;
+  }
+
+  bool
+  full () const
+  {
+    return m_size == m_buffer.size ();
+  }
+
+  /**
+   * @brief Add element to the end of the queue (buffer should not be full)
+   */
+  void
+  push_back (const T &value)
+  {
+    NS_ASSERT (!full ());
+    m_buffer[Index (m_size)] = value;
+    m_size ++;
+  }
+
+  T &
+  front ()
+  {
+    NS_ASSERT (!empty ());
+    return m_buffer[m_head];
+  }
+
+  const T &
+  front () const
+  {
+    NS_ASSERT (!empty ());
+    return m_buffer[m_head];
+  }
+
+  /**
+   * @brief Remove the first element of the queue (element is reset, e.g., smart pointers are released)
+   */
+  void
+  pop_front ()
+  {
+    NS_ASSERT (!empty ());
+    m_buffer[m_head] = T ();
+    m_head = Index (1);
+    m_size --;
+  }
+
+  /**
+   * @brief Access i-th element, counting from the front of the queue
+   */
+  T &
+  operator [] (size_type i)
+  {
+    NS_ASSERT (i < m_size);
+    return m_buffer[Index (i)];
+  }
+
+  const T &
+  operator [] (size_type i) const
+  {
+    NS_ASSERT (i < m_size);
+    return m_buffer[Index (i)];
+  }
+
+  void
+  clear ()
+  {
+    while (!empty ())
+      pop_front ();
+    m_head = 0;
+  }
+
+private:
+  size_type
+  Index (size_type i) const
+  {
+    size_type index = m_head + i;
+    return index < m_buffer.size () ? index : index - m_buffer.size ();
+  }
+
+private:
+  std::vector<T> m_buffer;
+  size_type m_head;
+  size_type m_size;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // NDN_RING_BUFFER_H
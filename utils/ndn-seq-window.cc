@@ -0,0 +1,254 @@
+/* -*- Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2013 University of California, Los Angeles
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Alexander Afanasyev <alexander.afanasyev@ucla.edu>
+ */
+
+#include "ndn-seq-window.h"
+
+#include "ns3/assert.h"
+
+#include <algorithm>
+
+namespace ns3 {
+namespace ndn {
+
+const uint32_t SeqWindow::NONE;
+
+SeqWindow::SeqWindow (uint32_t capacity/* = 64*/)
+  : m_size (0)
+  , m_outstandingCount (0)
+  , m_head (NONE)
+  , m_tail (NONE)
+{
+  uint32_t realCapacity = 2;
+  while (realCapacity < capacity)
+    realCapacity <<= 1;
+
+  m_seq.resize (realCapacity);
+  m_state.resize (realCapacity, EMPTY);
+  m_firstSendTime.resize (realCapacity);
+  m_lastSendTime.resize (realCapacity);
+  m_transmissions.resize (realCapacity);
+  m_prev.resize (realCapacity, NONE);
+  m_next.resize (realCapacity, NONE);
+}
+
+uint32_t
+SeqWindow::Find (uint32_t seq) const
+{
+  uint32_t mask = m_seq.size () - 1;
+  for (uint32_t slot = Home (seq); m_state[slot] != EMPTY; slot = (slot + 1) & mask)
+    {
+      if (m_seq[slot] == seq)
+        return slot;
+    }
+  return NONE;
+}
+
+bool
+SeqWindow::IsOutstanding (uint32_t seq) const
+{
+  uint32_t slot = Find (seq);
+  return slot != NONE && m_state[slot] == OUTSTANDING;
+}
+
+void
+SeqWindow::Sent (uint32_t seq, const Time &now)
+{
+  uint32_t slot = Find (seq);
+  if (slot == NONE)
+    {
+      slot = Insert (seq);
+      m_firstSendTime[slot] = now;
+      m_transmissions[slot] = 0;
+    }
+  else if (m_state[slot] == OUTSTANDING)
+    {
+      Unlink (slot);
+    }
+
+  m_lastSendTime[slot] = now;
+  m_transmissions[slot] ++;
+  LinkTail (slot);
+}
+
+void
+SeqWindow::StopTimer (uint32_t seq)
+{
+  uint32_t slot = Find (seq);
+  if (slot != NONE && m_state[slot] == OUTSTANDING)
+    Unlink (slot);
+}
+
+void
+SeqWindow::Erase (uint32_t seq)
+{
+  uint32_t slot = Find (seq);
+  if (slot == NONE)
+    return;
+
+  if (m_state[slot] == OUTSTANDING)
+    Unlink (slot);
+
+  m_state[slot] = EMPTY;
+  m_size --;
+
+  // backward shift deletion: move up records that would not be found anymore
+  uint32_t mask = m_seq.size () - 1;
+  uint32_t hole = slot;
+  for (uint32_t next = (hole + 1) & mask; m_state[next] != EMPTY; next = (next + 1) & mask)
+    {
+      // distance from the home position of the record is less than the distance from the hole
+      uint32_t home = Home (m_seq[next]);
+      if (((next - home) & mask) >= ((next - hole) & mask))
+        {
+          Move (next, hole);
+          hole = next;
+        }
+    }
+}
+
+uint32_t
+SeqWindow::Insert (uint32_t seq)
+{
+  if (2 * (m_size + 1) > m_seq.size ())
+    Grow ();
+
+  uint32_t mask = m_seq.size () - 1;
+  uint32_t slot = Home (seq);
+  while (m_state[slot] != EMPTY)
+    slot = (slot + 1) & mask;
+
+  m_seq[slot] = seq;
+  m_state[slot] = USED;
+  m_size ++;
+  return slot;
+}
+
+void
+SeqWindow::Grow ()
+{
+  SeqWindow bigger (m_seq.size () * 2);
+
+  // outstanding records first, to keep the timer order
+  for (uint32_t slot = m_head; slot != NONE; slot = m_next[slot])
+    {
+      uint32_t newSlot = bigger.Insert (m_seq[slot]);
+      bigger.m_firstSendTime[newSlot] = m_firstSendTime[slot];
+      bigger.m_lastSendTime[newSlot] = m_lastSendTime[slot];
+      bigger.m_transmissions[newSlot] = m_transmissions[slot];
+      bigger.LinkTail (newSlot);
+    }
+
+  for (uint32_t slot = 0; slot < m_seq.size (); slot++)
+    {
+      if (m_state[slot] != USED)
+        continue;
+
+      uint32_t newSlot = bigger.Insert (m_seq[slot]);
+      bigger.m_firstSendTime[newSlot] = m_firstSendTime[slot];
+      bigger.m_lastSendTime[newSlot] = m_lastSendTime[slot];
+      bigger.m_transmissions[newSlot] = m_transmissions[slot];
+    }
+
+  swap (bigger);
+}
+
+void
+SeqWindow::LinkTail (uint32_t slot)
+{
+  m_state[slot] = OUTSTANDING;
+  m_prev[slot] = m_tail;
+  m_next[slot] = NONE;
+  if (m_tail != NONE)
+    m_next[m_tail] = slot;
+  else
+    m_head = slot;
+  m_tail = slot;
+  m_outstandingCount ++;
+}
+
+void
+SeqWindow::Unlink (uint32_t slot)
+{
+  NS_ASSERT (m_state[slot] == OUTSTANDING);
+
+  if (m_prev[slot] != NONE)
+    m_next[m_prev[slot]] = m_next[slot];
+  else
+    m_head = m_next[slot];
+
+  if (m_next[slot] != NONE)
+    m_prev[m_next[slot]] = m_prev[slot];
+  else
+    m_tail = m_prev[slot];
+
+  m_prev[slot] = NONE;
+  m_next[slot] = NONE;
+  m_state[slot] = USED;
+  m_outstandingCount --;
+}
+
+void
+SeqWindow::Move (uint32_t from, uint32_t to)
+{
+  m_seq[to] = m_seq[from];
+  m_state[to] = m_state[from];
+  m_firstSendTime[to] = m_firstSendTime[from];
+  m_lastSendTime[to] = m_lastSendTime[from];
+  m_transmissions[to] = m_transmissions[from];
+  m_prev[to] = m_prev[from];
+  m_next[to] = m_next[from];
+
+  if (m_state[to] == OUTSTANDING)
+    {
+      if (m_prev[to] != NONE)
+        m_next[m_prev[to]] = to;
+      else
+        m_head = to;
+
+      if (m_next[to] != NONE)
+        m_prev[m_next[to]] = to;
+      else
+        m_tail = to;
+    }
+
+  m_state[from] = EMPTY;
+  m_prev[from] = NONE;
+  m_next[from] = NONE;
+}
+
+void
+SeqWindow::swap (SeqWindow &other)
+{
+  m_seq.swap (other.m_seq);
+  m_state.swap (other.m_state);
+  m_firstSendTime.swap (other.m_firstSendTime);
+  m_lastSendTime.swap (other.m_lastSendTime);
+  m_transmissions.swap (other.m_transmissions);
+  m_prev.swap (other.m_prev);
+  m_next.swap (other.m_next);
+
+  std::swap (m_size, other.m_size);
+  std::swap (m_outstandingCount, other.m_outstandingCount);
+  std::swap (m_head, other.m_head);
+  std::swap (m_tail, other.m_tail);
+}
+
+} // namespace ndn
+} // namespace ns3
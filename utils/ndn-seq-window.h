@@ -0,0 +1,201 @@
+/* -*- Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2013 University of California, Los Angeles
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Alexander Afanasyev <alexander.afanasyev@ucla.edu>
+ */
+
+#ifndef NDN_SEQ_WINDOW_H
+#define NDN_SEQ_WINDOW_H
+
+#include "ns3/nstime.h"
+
+#include <vector>
+#include <stdint.h>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * @ingroup ndn
+ * @brief Table of sequence numbers requested by a consumer, but not yet satisfied with Data
+ *
+ * For each sequence number the table keeps time of the first and the last transmission of the Interest
+ * and number of transmissions.  Sequence numbers that are waiting for Data or timeout ("outstanding")
+ * are additionally linked into a list ordered by the time when their retransmission timer was started.
+ *
+ * Records are stored as a structure of arrays, indexed by (seq mod capacity), with linear probing
+ * in case of collisions (e.g., for random sequence numbers).  Capacity is a power of two and is doubled
+ * when the table is half full, so per-packet operations take O(1) and do not allocate memory.
+ *
+ * Records are addressed by slot numbers (see Find), which are valid only until the next
+ * modification of the table.
+ */
+class SeqWindow
+{
+public:
+  static const uint32_t NONE = 0xFFFFFFFF; ///< @brief "no slot" value
+
+  /**
+   * @brief Create table with the initial capacity (rounded up to a power of two)
+   */
+  SeqWindow (uint32_t capacity = 64);
+
+  /**
+   * @brief Record transmission of the Interest for the sequence number
+   *
+   * On the first transmission new record is created.  Last transmission time and number of transmissions
+   * are updated, and the retransmission timer is (re)started, i.e., the sequence number is moved to
+   * the end of the outstanding list.
+   */
+  void
+  Sent (uint32_t seq, const Time &now);
+
+  /**
+   * @brief Stop retransmission timer for the sequence number (on timeout or NACK), keeping the record
+   */
+  void
+  StopTimer (uint32_t seq);
+
+  /**
+   * @brief Remove record for the sequence number (e.g., when Data is received)
+   */
+  void
+  Erase (uint32_t seq);
+
+  /**
+   * @brief Find slot of the sequence number (NONE if there is no record)
+   */
+  uint32_t
+  Find (uint32_t seq) const;
+
+  /**
+   * @brief Check if retransmission timer is running for the sequence number
+   */
+  bool
+  IsOutstanding (uint32_t seq) const;
+
+  /**
+   * @brief Get number of sequence numbers with running retransmission timer
+   */
+  uint32_t
+  GetOutstandingCount () const
+  {
+    return m_outstandingCount;
+  }
+
+  /**
+   * @brief Get slot of the sequence number with the oldest retransmission timer (NONE if nothing is outstanding)
+   */
+  uint32_t
+  GetOldestOutstanding () const
+  {
+    return m_head;
+  }
+
+  /**
+   * @brief Get number of records in the table
+   */
+  uint32_t
+  size () const
+  {
+    return m_size;
+  }
+
+  uint32_t
+  GetSeq (uint32_t slot) const
+  {
+    return m_seq[slot];
+  }
+
+  /**
+   * @brief Get time of the first transmission
+   */
+  const Time &
+  GetFirstSendTime (uint32_t slot) const
+  {
+    return m_firstSendTime[slot];
+  }
+
+  /**
+   * @brief Get time of the last transmission (for outstanding sequence numbers, it is the time when the timer was started)
+   */
+  const Time &
+  GetLastSendTime (uint32_t slot) const
+  {
+    return m_lastSendTime[slot];
+  }
+
+  /**
+   * @brief Get number of transmissions (1 if Interest has not been retransmitted)
+   */
+  uint32_t
+  GetTransmissionCount (uint32_t slot) const
+  {
+    return m_transmissions[slot];
+  }
+
+  void
+  swap (SeqWindow &other);
+
+private:
+  enum State
+    {
+      EMPTY = 0,
+      USED,
+      OUTSTANDING
+    };
+
+  inline uint32_t
+  Home (uint32_t seq) const
+  {
+    return seq & (m_seq.size () - 1);
+  }
+
+  uint32_t
+  Insert (uint32_t seq);
+
+  void
+  Grow ();
+
+  void
+  LinkTail (uint32_t slot);
+
+  void
+  Unlink (uint32_t slot);
+
+  void
+  Move (uint32_t from, uint32_t to);
+
+private:
+  std::vector<uint32_t> m_seq;
+  std::vector<uint8_t>  m_state;
+  std::vector<Time>     m_firstSendTime;
+  std::vector<Time>     m_lastSendTime;
+  std::vector<uint32_t> m_transmissions;
+  std::vector<uint32_t> m_prev; ///< @brief previous slot in the outstanding list
+  std::vector<uint32_t> m_next; ///< @brief next slot in the outstanding list
+
+  uint32_t m_size;
+  uint32_t m_outstandingCount;
+  uint32_t m_head; ///< @brief oldest outstanding slot
+  uint32_t m_tail; ///< @brief newest outstanding slot
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // NDN_SEQ_WINDOW_H
@@ -0,0 +1,92 @@
+/* -*- Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2013 University of California, Los Angeles
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Alexander Afanasyev <alexander.afanasyev@ucla.edu>
+ */
+
+#include "ndn-zipf-mandelbrot-sampler.h"
+
+#include "ns3/assert.h"
+#include "ns3/log.h"
+
+#include <boost/tuple/tuple.hpp>
+#include <boost/tuple/tuple_comparison.hpp>
+#include <boost/weak_ptr.hpp>
+
+#include <cmath>
+#include <map>
+#include <vector>
+
+NS_LOG_COMPONENT_DEFINE ("ndn.ZipfMandelbrotSampler");
+
+namespace ns3 {
+namespace ndn {
+
+namespace {
+typedef boost::tuple<uint32_t, double, double> SamplerParameters;
+typedef std::map<SamplerParameters, boost::weak_ptr<const ZipfMandelbrotSampler> > SamplerCache;
+
+SamplerCache &
+GetSamplerCache ()
+{
+  static SamplerCache cache;
+  return cache;
+}
+}
+
+boost::shared_ptr<const ZipfMandelbrotSampler>
+ZipfMandelbrotSampler::Get (uint32_t numberOfContents, double q, double s)
+{
+  SamplerCache &cache = GetSamplerCache ();
+  SamplerParameters parameters (numberOfContents, q, s);
+
+  boost::shared_ptr<const ZipfMandelbrotSampler> sampler = cache[parameters].lock ();
+  if (!sampler)
+    {
+      // clean up samplers that are not used anymore
+      for (SamplerCache::iterator item = cache.begin (); item != cache.end (); )
+        {
+          if (item->second.expired () && item->first != parameters)
+            cache.erase (item++);
+          else
+            item++;
+        }
+
+      sampler = boost::shared_ptr<const ZipfMandelbrotSampler> (new ZipfMandelbrotSampler (numberOfContents, q, s));
+      cache[parameters] = sampler;
+    }
+  return sampler;
+}
+
+ZipfMandelbrotSampler::ZipfMandelbrotSampler (uint32_t numberOfContents, double q, double s)
+  : m_q (q)
+  , m_s (s)
+{
+  NS_LOG_FUNCTION (numberOfContents << q << s);
+  NS_ASSERT_MSG (numberOfContents > 0, "Number of contents should be positive");
+
+  std::vector<double> weights (numberOfContents);
+  for (uint32_t i = 0; i < numberOfContents; i++)
+    {
+      weights[i] = 1.0 / std::pow (i + 1 + m_q, m_s);
+    }
+
+  m_table.Build (weights);
+}
+
+} // namespace ndn
+} // namespace ns3
@@ -0,0 +1,93 @@
+/* -*- Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2013 University of California, Los Angeles
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Alexander Afanasyev <alexander.afanasyev@ucla.edu>
+ */
+
+#ifndef NDN_ZIPF_MANDELBROT_SAMPLER_H
+#define NDN_ZIPF_MANDELBROT_SAMPLER_H
+
+#include "ndn-alias-table.h"
+
+#include <stdint.h>
+
+#include <boost/shared_ptr.hpp>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * @ingroup ndn
+ * @brief Sampler of content ranks from Zipf-Mandelbrot distribution, p(k) ~ 1/(k+q)^s, k in [1, N]
+ *
+ * Walker's alias method is used: sampling takes O(1), table is built once in O(N).
+ * Tables are immutable and shared between all users requesting the same (N, q, s) parameters.
+ */
+class ZipfMandelbrotSampler
+{
+public:
+  /**
+   * @brief Get (build, if necessary) sampler for the specified parameters
+   *
+   * The sampler is shared while there is at least one reference to it
+   */
+  static boost::shared_ptr<const ZipfMandelbrotSampler>
+  Get (uint32_t numberOfContents, double q, double s);
+
+  /**
+   * @brief Build sampler (it is recommended to use shared samplers from Get ())
+   */
+  ZipfMandelbrotSampler (uint32_t numberOfContents, double q, double s);
+
+  /**
+   * @brief Get content rank in [1, N] for the uniformly distributed random value in [0, 1)
+   */
+  inline uint32_t
+  Sample (double uniform) const
+  {
+    return m_table.Sample (uniform) + 1;
+  }
+
+  uint32_t
+  GetNumberOfContents () const
+  {
+    return m_table.GetSize ();
+  }
+
+  double
+  GetQ () const
+  {
+    return m_q;
+  }
+
+  double
+  GetS () const
+  {
+    return m_s;
+  }
+
+private:
+  double m_q;
+  double m_s;
+
+  AliasTable m_table; ///< @brief alias table of content ranks (index is rank - 1)
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // NDN_ZIPF_MANDELBROT_SAMPLER_H
@@ -23,6 +23,8 @@
 
 #include "trie.h"
 
+#include <algorithm>
+
 namespace ns3 {
 namespace ndn {
 namespace ndnSIM {
@@ -166,6 +168,23 @@ public:
     return foundItem;
   }
 
+  /**
+   * @brief Find all nodes along the path of the key that satisfy predicate (from the longest to the shortest prefix)
+   */
+  template<class Predicate, class Container>
+  inline void
+  all_prefix_matches_if (const FullKey &key, Predicate pred, Container &items)
+  {
+    typename Container::size_type first = items.size ();
+    trie_.find_all_if (key, pred, items);
+    std::reverse (items.begin () + first, items.end ());
+
+    for (typename Container::iterator item = items.begin () + first; item != items.end (); item++)
+      {
+        policy_.lookup (s_iterator_to (*item));
+      }
+  }
+
   // /**
   //  * @brief Const version of the longest common prefix match
   //  * (semi-const, because there could be update of the policy anyways)
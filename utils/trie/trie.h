@@ -365,6 +365,35 @@ public:
     return boost::make_tuple (foundNode, reachLast, trieNode);
   }
 
+  /**
+   * @brief Find all nodes along the path of the key, whose payloads satisfy predicate
+   * @param key the key for which to perform the lookup
+   * @param pred predicate
+   * @param items container to which iterators are appended (from the shortest to the longest prefix)
+   */
+  template<class Predicate, class Container>
+  inline void
+  find_all_if (const FullKey &key, Predicate pred, Container &items)
+  {
+    trie *trieNode = this;
+    if (payload_ != PayloadTraits::empty_payload && pred (payload_))
+      items.push_back (this);
+
+    BOOST_FOREACH (const Key &subkey, key)
+      {
+        typename unordered_set::iterator item = trieNode->children_.find (subkey);
+        if (item == trieNode->children_.end ())
+          break;
+
+        trieNode = &(*item);
+        if (trieNode->payload_ != PayloadTraits::empty_payload &&
+            pred (trieNode->payload_))
+          {
+            items.push_back (trieNode);
+          }
+      }
+  }
+
   /**
    * @brief Find next payload of the sub-trie
    * @returns end() or a valid iterator pointing to the trie leaf (order is not defined, enumeration )